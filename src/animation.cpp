@@ -0,0 +1,57 @@
+#include "animation.h"
+#include "frame-profiler.h"
+
+AnimationPlayer animationPlayer;
+
+const char* getAnimationName(AnimationMode mode) {
+    Animation* animation = AnimationRegistry::get(mode);
+    return animation ? animation->getName() : "Unknown";
+}
+
+void AnimationRegistry::printFootprint() {
+    Serial.print("Effect state arena: ");
+    Serial.print(arenaSize());
+    Serial.println(" bytes, per effect:");
+    for (int mode = 0; mode < ANIMATION_MODE_COUNT; mode++) {
+        Animation* animation = get(mode);
+        Serial.print("  ");
+        Serial.print(animation->getName());
+        Serial.print(": ");
+        Serial.println(animation->stateBytes());
+    }
+}
+
+void AnimationPlayer::select(AnimationMode mode) {
+    Animation* next = AnimationRegistry::get(mode);
+    if (!next) {
+        return;
+    }
+
+    if (active) {
+        active->end();
+    }
+    frameBuffer.clear();
+    frameBuffer.show();
+    active = next;
+    active->begin();
+}
+
+void AnimationPlayer::stop() {
+    if (active) {
+        active->end();
+        active = nullptr;
+    }
+}
+
+void AnimationPlayer::frame(uint32_t dtUs) {
+    if (!active) {
+        return;
+    }
+
+    frameProfiler.startFrame();
+    active->update(dtUs);
+    active->render(frameBuffer);
+    // Attribute the cost to the effect on screen, also when it runs inside Auto Cycle
+    frameProfiler.endFrame(active->visible()->getMode());
+    frameBuffer.show();
+}
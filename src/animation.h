@@ -0,0 +1,73 @@
+// animation.h - Animation interface, registry of all effects and the player that runs one
+#pragma once
+
+#include <Arduino.h>
+#include "webserver.h"
+#include "framebuffer.h"
+
+// One effect. begin() resets its state when it is switched in, update() advances it
+// by dtUs of animation time (speed already applied), render() draws the current state
+// into the frame buffer and end() releases anything held while it was active. Static
+// effects have nothing to advance and keep the empty update().
+class Animation {
+public:
+    static const uint16_t DEFAULT_FPS = 50;
+
+    Animation(AnimationMode mode, const char* name) : mode(mode), name(name) {}
+    virtual ~Animation() {}
+
+    virtual void begin() {}
+    virtual void update(uint32_t) {}
+    virtual void render(Canvas& canvas) = 0;
+    virtual void end() {}
+
+    AnimationMode getMode() const { return mode; }
+    const char* getName() const { return name; }
+    // RAM this effect takes from the shared state arena while it runs
+    virtual size_t stateBytes() const { return 0; }
+    // Effect actually on screen; playlists such as Auto Cycle report their current entry
+    virtual const Animation* visible() const { return this; }
+    // Frame rate the effect wants while it is selected
+    virtual uint16_t targetFps() const { return DEFAULT_FPS; }
+
+private:
+    AnimationMode mode;
+    const char* name;
+};
+
+// Every effect, indexed by AnimationMode (defined in animations.cpp)
+class AnimationRegistry {
+public:
+    static Animation* get(AnimationMode mode) { return mode < ANIMATION_MODE_COUNT ? animations[mode] : nullptr; }
+    static Animation* get(int mode) { return mode >= 0 ? get((AnimationMode)mode) : nullptr; }
+
+    // Shared effect state arena: capacity (the largest stateBytes()) and current use
+    static size_t arenaSize();
+    static size_t arenaUsed();
+    static void printFootprint();
+
+private:
+    static Animation* const animations[ANIMATION_MODE_COUNT];
+};
+
+// Runs the selected effect: switching is end() on the old one and begin() on the new
+// one, and every frame goes through update/render with profiling and output attached.
+class AnimationPlayer {
+public:
+    AnimationPlayer() : active(nullptr) {}
+
+    void select(AnimationMode mode);
+    // End the active effect and run none until the next select()
+    void stop();
+    void frame(uint32_t dtUs);
+
+    // ANIMATION_MODE_COUNT until something has been selected
+    AnimationMode getMode() const { return active ? active->getMode() : ANIMATION_MODE_COUNT; }
+    const Animation* visible() const { return active ? active->visible() : nullptr; }
+    uint16_t targetFps() const { return active ? active->targetFps() : Animation::DEFAULT_FPS; }
+
+private:
+    Animation* active;
+};
+
+extern AnimationPlayer animationPlayer;
@@ -0,0 +1,776 @@
+// animations.cpp - All display effects and the registry table that lists them
+#include <Adafruit_NeoPixel.h>
+#include "animation.h"
+#include "matrix-geometry.h"
+#include "trig-lut.h"
+#include "frame-clock.h"
+#include "effect-arena.h"
+#include "transition.h"
+#include "palette.h"
+#include "prng.h"
+#include "font.h"
+#include "line.h"
+#include "marquee.h"
+#include "stream-receiver.h"
+
+static uint32_t rgb(uint8_t r, uint8_t g, uint8_t b) {
+    return Adafruit_NeoPixel::Color(r, g, b);
+}
+
+// Effect state. Each effect's working buffers live in one of these while it runs;
+// they share a single arena sized to the largest, constructed zeroed on begin().
+struct QixState {
+    struct Line {
+        float x1, y1, x2, y2;
+        float dx1, dy1, dx2, dy2;
+    } lines[2];
+};
+
+struct StarfieldState {
+    struct Star {
+        float x, y;
+        float speed;
+        uint8_t brightness;
+        bool active;
+    } stars[16];
+    uint32_t spawnAccumulator;
+    Prng rng;
+};
+
+struct StarWarpState {
+    struct WarpStar {
+        float startX, startY; // Starting position near center
+        float dx, dy;         // Direction vector
+        float speed;
+        uint8_t brightness;
+        bool active;
+        float life;           // How far along the warp path (0.0 to 1.0)
+    } warpStars[24];
+    uint32_t spawnAccumulator;
+    Prng rng;
+};
+
+struct NebulaState {
+    // 16.16 phase accumulators
+    uint32_t rotationPhase;
+    uint32_t colorPhase;
+};
+
+// Per-pixel polar phases for the Nebula kernel, as 16-bit binary angles. Distance and
+// angle from the centre never change, so they are baked at compile time into the three
+// phases the kernel needs and each frame only adds the time-varying part. GCC folds
+// the math builtins in constant expressions; the table lives in flash, not the arena.
+struct NebulaPhases {
+    struct Pixel {
+        uint16_t spiral;  // angle + 0.3 * distance
+        uint16_t radial;  // 0.8 * distance
+        uint16_t color;   // angle + 0.2 * distance
+    } pixels[MATRIX_PIXELS];
+
+    constexpr NebulaPhases() : pixels() {
+        for (int y = 0; y < MATRIX_ROWS; y++) {
+            for (int x = 0; x < MATRIX_COLS; x++) {
+                float dx = x - MATRIX_COLS / 2.0f;
+                float dy = y - MATRIX_ROWS / 2.0f;
+                float distance = __builtin_sqrtf(dx * dx + dy * dy);
+                float angle = __builtin_atan2f(dy, dx);
+
+                Pixel& pixel = pixels[y * MATRIX_COLS + x];
+                pixel.spiral = radiansToAngle16(angle + distance * 0.3);
+                pixel.radial = radiansToAngle16(distance * 0.8);
+                pixel.color = radiansToAngle16(angle + distance * 0.2);
+            }
+        }
+    }
+};
+
+static constexpr NebulaPhases NEBULA_PHASES PROGMEM{};
+
+struct MatrixRainState {
+    int8_t head[MATRIX_COLS];
+    uint32_t stepAccumulator;
+    Prng rng;
+};
+
+struct FireState {
+    uint8_t heat[MATRIX_COLS][MATRIX_ROWS];
+    uint32_t stepAccumulator;
+    Prng rng;
+};
+
+template<typename T>
+constexpr size_t maxSize() { return sizeof(T); }
+template<typename T, typename U, typename... Rest>
+constexpr size_t maxSize() { return sizeof(T) > sizeof(U) ? maxSize<T, Rest...>() : maxSize<U, Rest...>(); }
+
+// Two slots: during an Auto Cycle transition the outgoing and incoming effect both run
+static EffectArena<maxSize<QixState, StarfieldState, StarWarpState, NebulaState, MatrixRainState, FireState>(), 2> effectArena;
+// Constant tables belong in flash; the arena is RAM taken for good
+static_assert(effectArena.size() <= 1536, "effect arena outgrew its RAM budget");
+
+// State for an effect's begin(). With no slot free the effect stays blank rather
+// than taking over the state of an effect that is still running.
+template<typename T>
+static T* createState(const Animation& animation) {
+    T* state = effectArena.create<T>();
+    if (!state) {
+        Serial.println(String("No effect arena slot free for ") + animation.getName());
+    }
+    return state;
+}
+
+// Temperature display from the AHT10 reading taken by the sensor task
+class TemperatureAnimation : public Animation {
+public:
+    TemperatureAnimation() : Animation(ANIMATION_TEMPERATURE, "Temperature") {}
+
+    void begin() override {
+        waveOffset = 0;
+        waveAccumulator = 0;
+    }
+
+    void update(uint32_t dtUs) override {
+        // Error wave scrolls one column per 200ms
+        waveOffset = (waveOffset + FrameClock::steps(waveAccumulator, dtUs, 200000)) % MATRIX_COLS;
+    }
+
+    void render(Canvas& canvas) override {
+        canvas.clear();
+        if (temperatureValid) {
+            renderDigits(canvas, currentTemperature);
+        } else {
+            renderError(canvas);
+        }
+    }
+
+private:
+    int waveOffset;
+    uint32_t waveAccumulator;
+
+    // Display temperature as e.g. "23.4°C", centred
+    void renderDigits(Canvas& canvas, float temperature) {
+        // Round temperature to 1 decimal place
+        int temp10 = (int)lroundf(temperature * 10);
+        char whole[12];
+        snprintf(whole, sizeof(whole), "%s%d", temp10 < 0 ? "-" : "", abs(temp10) / 10);
+        const char decimal[2] = { (char)('0' + abs(temp10) % 10), 0 };
+        const char unit[3] = { FONT_DEGREE, 'C', 0 };
+
+        uint32_t digitColor = rgb(0, 255, 100);    // Green-cyan color
+        uint32_t decimalColor = rgb(255, 100, 0);  // Orange for decimal point
+        uint32_t white = rgb(255, 255, 255);
+
+        const Font& font = FONT_5X7;
+        int width = Text::measure(font, whole) + Text::measure(font, ".") + Text::measure(font, decimal) +
+                    Text::measure(font, unit) + 3 * font.spacing;
+        int x = (MATRIX_COLS - width) / 2;
+
+        x = Text::draw(canvas, font, whole, x, 0, digitColor);
+        x = Text::draw(canvas, font, ".", x, 0, decimalColor);
+        x = Text::draw(canvas, font, decimal, x, 0, digitColor);
+        Text::draw(canvas, font, unit, x, 0, white);
+    }
+
+    // Display red wavy line when temperature reading fails
+    void renderError(Canvas& canvas) {
+        for (int x = 0; x < MATRIX_COLS; x++) {
+            int y = 3 + (int)(sin((x + waveOffset) * 0.5) * 1.5); // Wave oscillates around y=3
+            if (y >= 0 && y < MATRIX_ROWS) {
+                canvas.setPixelColor(DisplayGeometry::index(x, y), rgb(255, 0, 0));
+            }
+        }
+    }
+};
+
+// Qix-style moving lines
+class QixLinesAnimation : public Animation {
+public:
+    QixLinesAnimation() : Animation(ANIMATION_QIX_LINES, "Qix Lines") {}
+
+    void begin() override {
+        state = createState<QixState>(*this);
+        if (!state) return;
+        state->lines[0] = {16.0, 3.5, 24.0, 2.0, 0.3, 0.2, -0.4, 0.3};
+        state->lines[1] = {8.0, 1.0, 12.0, 5.5, 0.5, 0.1, -0.2, -0.4};
+    }
+
+    void end() override {
+        effectArena.release(state);
+    }
+
+    size_t stateBytes() const override { return sizeof(QixState); }
+
+    void update(uint32_t dtUs) override {
+        if (!state) return;
+        // Velocities are in pixels per 50ms step
+        float steps = dtUs / 50000.0f;
+
+        // Move line endpoints, bouncing off boundaries
+        for (QixState::Line& line : state->lines) {
+            moveAndBounce(line.x1, line.dx1, steps, MATRIX_COLS - 1);
+            moveAndBounce(line.y1, line.dy1, steps, MATRIX_ROWS - 1);
+            moveAndBounce(line.x2, line.dx2, steps, MATRIX_COLS - 1);
+            moveAndBounce(line.y2, line.dy2, steps, MATRIX_ROWS - 1);
+        }
+    }
+
+    void render(Canvas& canvas) override {
+        if (!state) {
+            canvas.clear();
+            return;
+        }
+        canvas.clear();
+        // Line 1 cyan, line 2 magenta; where they cross the light adds up
+        drawLine(canvas, state->lines[0].x1, state->lines[0].y1, state->lines[0].x2, state->lines[0].y2, rgb(0, 100, 100), BLEND_ADD);
+        drawLine(canvas, state->lines[1].x1, state->lines[1].y1, state->lines[1].x2, state->lines[1].y2, rgb(100, 0, 100), BLEND_ADD);
+    }
+
+private:
+    QixState* state;
+
+    // Move a coordinate by vel * steps and turn it around once it runs past 0..maxPos
+    static void moveAndBounce(float& pos, float& vel, float steps, float maxPos) {
+        pos += vel * steps;
+        if ((pos <= 0 && vel < 0) || (pos >= maxPos && vel > 0)) vel = -vel;
+    }
+};
+
+// Starfield - stars moving from left to right at different speeds
+class StarfieldAnimation : public Animation {
+public:
+    StarfieldAnimation() : Animation(ANIMATION_STARFIELD, "Starfield") {}
+
+    void begin() override {
+        state = createState<StarfieldState>(*this);
+        if (!state) return;
+        state->rng.seed(Prng::seedFor(getMode()));
+    }
+
+    void end() override {
+        effectArena.release(state);
+    }
+
+    size_t stateBytes() const override { return sizeof(StarfieldState); }
+
+    void update(uint32_t dtUs) override {
+        if (!state) return;
+        // Star speeds are in pixels per 80ms step
+        float steps = dtUs / 80000.0f;
+
+        // Create new stars randomly, one chance per elapsed 80ms step
+        uint16_t spawnChances = FrameClock::steps(state->spawnAccumulator, dtUs, 80000);
+        for (uint16_t chance = 0; chance < spawnChances; chance++) {
+            if (state->rng.chance(30)) {
+                for (StarfieldState::Star& star : state->stars) {
+                    if (!star.active) {
+                        star.x = -1.0;
+                        star.y = state->rng.below(MATRIX_ROWS);
+                        star.speed = 0.2 + (state->rng.below(100) / 100.0) * 0.8; // Speed between 0.2 and 1.0
+                        star.brightness = 50 + state->rng.below(150); // Brightness between 50 and 200
+                        star.active = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Move stars and retire the ones that left the display
+        for (StarfieldState::Star& star : state->stars) {
+            if (star.active) {
+                star.x += star.speed * steps;
+                if (star.x >= MATRIX_COLS) {
+                    star.active = false;
+                }
+            }
+        }
+    }
+
+    void render(Canvas& canvas) override {
+        if (!state) {
+            canvas.clear();
+            return;
+        }
+        canvas.clear();
+        for (const StarfieldState::Star& star : state->stars) {
+            if (star.active && star.x >= 0 && star.y >= 0 && star.y < MATRIX_ROWS) {
+                // White star with varying brightness
+                uint8_t b = star.brightness;
+                canvas.blendPixel(DisplayGeometry::index((int)star.x, (int)star.y), rgb(b, b, b), BLEND_ADD);
+            }
+        }
+    }
+
+private:
+    StarfieldState* state;
+};
+
+// Star Warp - first person perspective traveling through stars
+class StarWarpAnimation : public Animation {
+public:
+    StarWarpAnimation() : Animation(ANIMATION_STAR_WARP, "Star Warp") {}
+
+    void begin() override {
+        state = createState<StarWarpState>(*this);
+        if (!state) return;
+        state->rng.seed(Prng::seedFor(getMode()));
+    }
+
+    void end() override {
+        effectArena.release(state);
+    }
+
+    size_t stateBytes() const override { return sizeof(StarWarpState); }
+
+    void update(uint32_t dtUs) override {
+        if (!state) return;
+        const float centerX = MATRIX_COLS / 2.0;
+        const float centerY = MATRIX_ROWS / 2.0;
+
+        // Star life advances by speed per 60ms step
+        float steps = dtUs / 60000.0f;
+
+        // Create new warp stars randomly, one chance per elapsed 60ms step
+        uint16_t spawnChances = FrameClock::steps(state->spawnAccumulator, dtUs, 60000);
+        for (uint16_t chance = 0; chance < spawnChances; chance++) {
+            if (state->rng.chance(40)) {
+                for (StarWarpState::WarpStar& star : state->warpStars) {
+                    if (!star.active) {
+                        // Start near center with slight random offset
+                        star.startX = centerX + state->rng.range(-2, 3) * 0.5;
+                        star.startY = centerY + state->rng.range(-1, 2) * 0.5;
+
+                        // Calculate direction vector from center outward
+                        float dx = state->rng.range(-100, 101) / 50.0; // -2.0 to 2.0
+                        float dy = state->rng.range(-100, 101) / 50.0; // -2.0 to 2.0
+
+                        // Favor horizontal movement due to rectangular display
+                        if (abs(dx) < 0.3) dx = (dx < 0) ? -0.8 : 0.8;
+
+                        star.dx = dx;
+                        star.dy = dy;
+                        star.speed = 0.05 + (state->rng.below(50) / 100.0) * 0.1; // 0.05 to 0.10
+                        star.brightness = 60 + state->rng.below(120); // 60 to 180
+                        star.life = 0.0;
+                        star.active = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Update life progress and retire stars that reached the end
+        for (StarWarpState::WarpStar& star : state->warpStars) {
+            if (star.active) {
+                star.life += star.speed * steps;
+                if (star.life >= 1.0) {
+                    star.active = false;
+                }
+            }
+        }
+    }
+
+    void render(Canvas& canvas) override {
+        if (!state) {
+            canvas.clear();
+            return;
+        }
+        canvas.clear();
+        for (const StarWarpState::WarpStar& star : state->warpStars) {
+            if (!star.active) {
+                continue;
+            }
+
+            // Draw star trail effect; movement accelerates quadratically with life
+            for (int trail = 0; trail < 3; trail++) {
+                float trailLife = star.life - trail * 0.02;
+                if (trailLife <= 0) break;
+
+                float trailAccel = trailLife * trailLife;
+                float trailX = star.startX + star.dx * trailAccel * 20;
+                float trailY = star.startY + star.dy * trailAccel * 20;
+
+                // Check if trail point is within bounds
+                if (trailX >= 0 && trailX < MATRIX_COLS && trailY >= 0 && trailY < MATRIX_ROWS) {
+                    // White star with fading trail
+                    uint8_t brightness = star.brightness * (1.0 - trail * 0.4) * (1.0 - star.life * 0.2);
+                    // Overlapping trails add up instead of overwriting each other
+                    canvas.blendPixel(DisplayGeometry::index((int)trailX, (int)trailY), rgb(brightness, brightness, brightness), BLEND_ADD);
+                }
+            }
+        }
+    }
+
+private:
+    StarWarpState* state;
+};
+
+// Nebula Swirl - rotating cosmic clouds with changing colors
+class NebulaAnimation : public Animation {
+public:
+    NebulaAnimation() : Animation(ANIMATION_NEBULA, "Nebula Swirl") {}
+
+    void begin() override {
+        state = createState<NebulaState>(*this);
+    }
+
+    void end() override {
+        effectArena.release(state);
+    }
+
+    size_t stateBytes() const override { return sizeof(NebulaState); }
+
+    void update(uint32_t dtUs) override {
+        if (!state) return;
+        // Rotation 1.0 rad/s and colour cycling 0.625 rad/s at normal speed, in angle16 units per us << 16
+        state->rotationPhase += dtUs * 684;
+        state->colorPhase += dtUs * 427;
+    }
+
+    void render(Canvas& canvas) override {
+        if (!state) {
+            canvas.clear();
+            return;
+        }
+        // The top 16 bits of the phase accumulators are the binary angle
+        uint16_t rotationAngle = state->rotationPhase >> 16;
+        uint16_t colorAngleBase = state->colorPhase >> 16;
+        uint16_t radialShift = rotationAngle * 2;
+
+        const Palette& palette = palettes.forEffect(ANIMATION_NEBULA);
+
+        canvas.clear();
+
+        // Draw nebula swirl: all trig is table lookups, intensity is Q15
+        for (int i = 0; i < MATRIX_PIXELS; i++) {
+            const NebulaPhases::Pixel& phases = NEBULA_PHASES.pixels[i];
+
+            // Create rotating spiral arms
+            uint16_t spiralAngle = pgm_read_word(&phases.spiral) + rotationAngle;
+            int32_t spiralValue = (int32_t)sin16(spiralAngle * 3) + sin16(spiralAngle * 2);
+
+            // Add radial waves
+            int32_t radialWave = sin16(pgm_read_word(&phases.radial) + radialShift);
+
+            // Combine effects: (spiral + radial + 2) / 4, clamped to 0..1
+            int32_t intensity = (spiralValue + radialWave + 2 * 32768) >> 2;
+            if (intensity > 32767) intensity = 32767;
+
+            if (intensity > 3277) { // 0.1 in Q15
+                // Calculate color based on position and time
+                uint16_t colorAngle = pgm_read_word(&phases.color) + colorAngleBase;
+
+                // Palette colour at that angle, dimmed by intensity
+                uint32_t color = scaleColor(palette.get(colorAngle >> 8), intensity >> 7);
+                canvas.setPixelColor(DisplayGeometry::table.index[i], color);
+            }
+        }
+    }
+
+private:
+    NebulaState* state;
+};
+
+// All LEDs red at 10% brightness
+class AllRedAnimation : public Animation {
+public:
+    AllRedAnimation() : Animation(ANIMATION_RED, "All Red (10%)") {}
+
+    void render(Canvas& canvas) override {
+        // 25 out of 255; unchanged frames are not re-sent
+        canvas.fill(rgb(25, 0, 0));
+    }
+};
+
+// Matrix-style falling characters (green rain); heads fall one row per 90ms
+class MatrixRainAnimation : public Animation {
+public:
+    MatrixRainAnimation() : Animation(ANIMATION_MATRIX, "Matrix Rain") {}
+
+    void begin() override {
+        state = createState<MatrixRainState>(*this);
+        if (!state) return;
+        state->rng.seed(Prng::seedFor(getMode()));
+        for (int c = 0; c < MATRIX_COLS; c++) state->head[c] = -state->rng.range(1, MATRIX_ROWS + 1);
+    }
+
+    void end() override {
+        effectArena.release(state);
+    }
+
+    size_t stateBytes() const override { return sizeof(MatrixRainState); }
+
+    void update(uint32_t dtUs) override {
+        if (!state) return;
+        uint16_t steps = FrameClock::steps(state->stepAccumulator, dtUs, 90000);
+        for (uint16_t s = 0; s < steps; s++) {
+            for (int c = 0; c < MATRIX_COLS; c++) {
+                state->head[c]++;
+                if (state->head[c] > MATRIX_ROWS + state->rng.range(2, 4) && state->rng.chance(40)) {
+                    state->head[c] = -state->rng.range(1, MATRIX_ROWS);
+                }
+            }
+        }
+    }
+
+    void render(Canvas& canvas) override {
+        if (!state) {
+            canvas.clear();
+            return;
+        }
+        const int tailLen = 3;
+
+        canvas.clear();
+        for (int c = 0; c < MATRIX_COLS; c++) {
+            for (int t = 0; t < tailLen; t++) {
+                int row = state->head[c] - t;
+                if (row >= 0 && row < MATRIX_ROWS) {
+                    int idx = DisplayGeometry::index(c, row);
+                    if (t == 0) {
+                        canvas.setPixelColor(idx, rgb(180, 255, 180));
+                    } else {
+                        uint8_t g = (uint8_t)max(0, 200 - t * 50);
+                        canvas.setPixelColor(idx, rgb(0, g, 0));
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    MatrixRainState* state;
+};
+
+// Calm burning fire; the heat map evolves one step per 80ms
+class FireAnimation : public Animation {
+public:
+    FireAnimation() : Animation(ANIMATION_FIRE, "Fire Effect") {}
+
+    void begin() override {
+        state = createState<FireState>(*this);
+        if (!state) return;
+        state->rng.seed(Prng::seedFor(getMode()));
+    }
+
+    void end() override {
+        effectArena.release(state);
+    }
+
+    size_t stateBytes() const override { return sizeof(FireState); }
+
+    void update(uint32_t dtUs) override {
+        if (!state) return;
+        uint16_t steps = FrameClock::steps(state->stepAccumulator, dtUs, 80000);
+        for (uint16_t s = 0; s < steps; s++) {
+            step();
+        }
+    }
+
+    void render(Canvas& canvas) override {
+        if (!state) {
+            canvas.clear();
+            return;
+        }
+        const Palette& palette = palettes.forEffect(ANIMATION_FIRE);
+        for (int c = 0; c < MATRIX_COLS; c++) {
+            for (int r = 0; r < MATRIX_ROWS; r++) {
+                // Heat is already 0..255, i.e. a palette index
+                canvas.setPixelColor(DisplayGeometry::index(c, r), palette.get(state->heat[c][r]));
+            }
+        }
+    }
+
+private:
+    FireState* state;
+
+    // cool down and propagate upward
+    void step() {
+        // One batch of random bytes per column: ignition chance and strength,
+        // bottom decay and a flicker per row, each scaled to its range by multiply
+        uint8_t noise[MATRIX_ROWS + 2];
+        for (int c = 0; c < MATRIX_COLS; c++) {
+            state->rng.fill(noise, sizeof(noise));
+
+            // random ignition at the bottom, 20% of the time
+            if (noise[0] < 51) {
+                // smaller ignition bursts to reduce overall brightness
+                int v = state->heat[c][0] + 50 + ((noise[1] * 90) >> 8);
+                if (v > 255) v = 255;
+                state->heat[c][0] = v;
+            }
+
+            // propagate upwards with some decay and a little random flicker
+            for (int r = MATRIX_ROWS - 1; r > 0; r--) {
+                int a = state->heat[c][r - 1];
+                int b = (r > 1) ? state->heat[c][r - 2] : 0;
+                int val = (a + b) / 2;
+                state->heat[c][r] = max(0, val - ((noise[2 + r] * 30) >> 8));
+            }
+
+            // small decay at the bottom
+            state->heat[c][0] = max(0, state->heat[c][0] - 40 - ((noise[2] * 60) >> 8));
+        }
+    }
+};
+
+// Color picker mode - solid selected color on the entire matrix
+class ColorPickerAnimation : public Animation {
+public:
+    ColorPickerAnimation() : Animation(ANIMATION_COLOR_PICKER, "Color Picker") {}
+
+    void render(Canvas& canvas) override {
+        canvas.fill(selectedColor);
+    }
+};
+
+// Drawing mode - displays the user-drawn image
+class DrawModeAnimation : public Animation {
+public:
+    DrawModeAnimation() : Animation(ANIMATION_DRAW_MODE, "Draw Mode") {}
+
+    void render(Canvas& canvas) override {
+        canvas.clear();
+        // Draw pixels based on drawing grid with their stored colors
+        for (int col = 0; col < MATRIX_COLS; col++) {
+            for (int row = 0; row < MATRIX_ROWS; row++) {
+                if (drawingGrid[col][row] != 0) {
+                    canvas.setPixelColor(DisplayGeometry::index(col, row), drawingGrid[col][row]);
+                }
+            }
+        }
+    }
+};
+
+// Auto Cycle - plays a list of effects for 10 seconds each, starting with temperature,
+// handing each one over to the next through the transition engine
+class AutoCycleAnimation : public Animation {
+public:
+    AutoCycleAnimation() : Animation(ANIMATION_AUTO, "Auto Cycle"), current(nullptr), index(0), started(0) {}
+
+    void begin() override {
+        index = 0;
+        start();
+    }
+
+    void update(uint32_t dtUs) override {
+        // Entries change on wall time so the speed setting does not stretch the playlist
+        if (millis() - started >= ENTRY_DURATION_MS) {
+            // The outgoing effect keeps running until the transition has mixed it out
+            transition.start(current);
+            index = (index + 1) % PLAYLIST_LENGTH;
+            start();
+            Serial.print("Auto switching to animation: ");
+            Serial.println(current->getName());
+        }
+        current->update(dtUs);
+        transition.update(dtUs);
+    }
+
+    void render(Canvas& canvas) override {
+        current->render(canvas);
+        transition.render(canvas);
+    }
+
+    void end() override {
+        transition.cancel();
+        if (current) {
+            current->end();
+        }
+    }
+
+    const Animation* visible() const override {
+        return current ? current : this;
+    }
+
+private:
+    static const unsigned long ENTRY_DURATION_MS = 10000;
+    static constexpr AnimationMode PLAYLIST[] = {
+        ANIMATION_TEMPERATURE, ANIMATION_STARFIELD, ANIMATION_STAR_WARP,
+        ANIMATION_NEBULA, ANIMATION_MATRIX, ANIMATION_FIRE
+    };
+    static const uint8_t PLAYLIST_LENGTH = sizeof(PLAYLIST) / sizeof(PLAYLIST[0]);
+
+    Animation* current;
+    uint8_t index;
+    unsigned long started;
+
+    void start() {
+        current = AnimationRegistry::get(PLAYLIST[index]);
+        current->begin();
+        started = millis();
+    }
+};
+
+constexpr AnimationMode AutoCycleAnimation::PLAYLIST[];
+
+// Scrolling text ticker; the message, speed and colour are set over HTTP
+class MarqueeAnimation : public Animation {
+public:
+    MarqueeAnimation() : Animation(ANIMATION_MARQUEE, "Marquee") {}
+
+    void begin() override {
+        marquee.restart();
+    }
+
+    void update(uint32_t dtUs) override {
+        marquee.advance(dtUs);
+    }
+
+    void render(Canvas& canvas) override {
+        marquee.render(canvas);
+    }
+
+    // Fractional scrolling reads best at a higher rate than the other effects
+    uint16_t targetFps() const override { return 60; }
+};
+
+// Frames streamed over UDP by xLights, LedFx and the like; the receiver selects this
+// mode when packets arrive and restores the previous one when they stop
+class StreamAnimation : public Animation {
+public:
+    StreamAnimation() : Animation(ANIMATION_STREAM, "UDP Stream") {}
+
+    void render(Canvas& canvas) override {
+        // Channels come in row order, which is the geometry table's logical order
+        const uint8_t* channels = streamReceiver.frame();
+        for (uint16_t i = 0; i < DisplayGeometry::PIXELS; i++, channels += 3) {
+            canvas.setPixelColor(DisplayGeometry::table.index[i], rgb(channels[0], channels[1], channels[2]));
+        }
+    }
+
+    // Show a new frame soon after it arrives; senders run at 40 fps and more
+    uint16_t targetFps() const override { return 60; }
+};
+
+static TemperatureAnimation temperatureAnimation;
+static QixLinesAnimation qixLinesAnimation;
+static StarfieldAnimation starfieldAnimation;
+static StarWarpAnimation starWarpAnimation;
+static NebulaAnimation nebulaAnimation;
+static AllRedAnimation allRedAnimation;
+static AutoCycleAnimation autoCycleAnimation;
+static MatrixRainAnimation matrixRainAnimation;
+static FireAnimation fireAnimation;
+static ColorPickerAnimation colorPickerAnimation;
+static DrawModeAnimation drawModeAnimation;
+static MarqueeAnimation marqueeAnimation;
+static StreamAnimation streamAnimation;
+
+size_t AnimationRegistry::arenaSize() { return effectArena.size(); }
+size_t AnimationRegistry::arenaUsed() { return effectArena.getUsed(); }
+
+// Same order as AnimationMode
+Animation* const AnimationRegistry::animations[ANIMATION_MODE_COUNT] = {
+    &temperatureAnimation,
+    &qixLinesAnimation,
+    &starfieldAnimation,
+    &starWarpAnimation,
+    &nebulaAnimation,
+    &allRedAnimation,
+    &autoCycleAnimation,
+    &matrixRainAnimation,
+    &fireAnimation,
+    &colorPickerAnimation,
+    &drawModeAnimation,
+    &marqueeAnimation,
+    &streamAnimation,
+};
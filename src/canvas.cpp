@@ -0,0 +1,87 @@
+#include "canvas.h"
+
+Canvas::Canvas(uint16_t numPixels) : pixelCount(numPixels) {
+    pixels = new Rgb16[pixelCount];
+    memset(pixels, 0, pixelCount * sizeof(Rgb16));
+    dirty = false;
+}
+
+Canvas::~Canvas() {
+    delete[] pixels;
+}
+
+void Canvas::clear() {
+    memset(pixels, 0, pixelCount * sizeof(Rgb16));
+    dirty = true;
+}
+
+void Canvas::fill(uint32_t color) {
+    fill(colorPipeline.toLinear(color));
+}
+
+void Canvas::fill(const Rgb16& color) {
+    for (uint16_t i = 0; i < pixelCount; i++) {
+        pixels[i] = color;
+    }
+    dirty = true;
+}
+
+void Canvas::setPixelColor(uint16_t index, uint32_t color) {
+    if (index < pixelCount) {
+        pixels[index] = colorPipeline.toLinear(color);
+        dirty = true;
+    }
+}
+
+void Canvas::setPixel(uint16_t index, const Rgb16& color) {
+    if (index < pixelCount) {
+        pixels[index] = color;
+        dirty = true;
+    }
+}
+
+void Canvas::blendPixel(uint16_t index, uint32_t color, BlendMode mode, uint8_t alpha) {
+    blendPixel(index, colorPipeline.toLinear(color), mode, alpha);
+}
+
+void Canvas::blendPixel(uint16_t index, const Rgb16& color, BlendMode mode, uint8_t alpha) {
+    if (index < pixelCount) {
+        pixels[index] = blend(pixels[index], color, mode, alpha);
+        dirty = true;
+    }
+}
+
+void Canvas::fade(uint16_t scale) {
+    for (uint16_t i = 0; i < pixelCount; i++) {
+        pixels[i].r = ((uint32_t)pixels[i].r * scale) >> 16;
+        pixels[i].g = ((uint32_t)pixels[i].g * scale) >> 16;
+        pixels[i].b = ((uint32_t)pixels[i].b * scale) >> 16;
+    }
+    dirty = true;
+}
+
+static inline uint16_t blendChannel(uint16_t dst, uint16_t src, BlendMode mode, uint8_t alpha) {
+    switch (mode) {
+        case BLEND_ADD: {
+            uint32_t sum = dst + ((src * (alpha + 1)) >> 8);
+            return sum > 0xFFFF ? 0xFFFF : sum;
+        }
+        case BLEND_ALPHA:
+            return dst + (int32_t)(((int32_t)src - dst) * (alpha + 1) >> 8);
+        case BLEND_MAX:
+            return src > dst ? src : dst;
+        case BLEND_MULTIPLY:
+            return ((uint32_t)dst * (src + 1)) >> 16;
+        case BLEND_REPLACE:
+        default:
+            return src;
+    }
+}
+
+Rgb16 Canvas::blend(const Rgb16& dst, const Rgb16& src, BlendMode mode, uint8_t alpha) {
+    Rgb16 result;
+    result.r = blendChannel(dst.r, src.r, mode, alpha);
+    result.g = blendChannel(dst.g, src.g, mode, alpha);
+    result.b = blendChannel(dst.b, src.b, mode, alpha);
+    return result;
+}
@@ -0,0 +1,45 @@
+// canvas.h - 16-bit-per-channel linear drawing surface with blend operations
+#pragma once
+
+#include <Arduino.h>
+#include "color-pipeline.h"
+
+enum BlendMode : uint8_t {
+    BLEND_REPLACE,   // overwrite
+    BLEND_ADD,       // accumulate light, saturating
+    BLEND_ALPHA,     // mix towards the colour by alpha
+    BLEND_MAX,       // brightest of the two per channel
+    BLEND_MULTIPLY   // darken/tint: 0xFFFF keeps the pixel, 0 clears it
+};
+
+// Pixels are stored as linear light, 16 bits per channel, so effects can add up
+// overlapping light and fade by multiplying without clipping at 8 bits first.
+// 8-bit colours (0x00RRGGBB, as drawn so far) are converted through the colour
+// pipeline's gamma table on the way in; quantising happens once, on output.
+class Canvas {
+public:
+    Canvas(uint16_t numPixels);
+    virtual ~Canvas();
+
+    uint16_t numPixels() const { return pixelCount; }
+
+    void clear();
+    void fill(uint32_t color);
+    void fill(const Rgb16& color);
+    void setPixelColor(uint16_t index, uint32_t color);
+    void setPixel(uint16_t index, const Rgb16& color);
+    void blendPixel(uint16_t index, uint32_t color, BlendMode mode, uint8_t alpha = 255);
+    void blendPixel(uint16_t index, const Rgb16& color, BlendMode mode, uint8_t alpha = 255);
+    // Multiply every pixel by scale / 65536, e.g. to leave fading trails
+    void fade(uint16_t scale);
+
+    const Rgb16& getPixel(uint16_t index) const { return pixels[index < pixelCount ? index : 0]; }
+    const Rgb16* getPixels() const { return pixels; }
+
+    static Rgb16 blend(const Rgb16& dst, const Rgb16& src, BlendMode mode, uint8_t alpha);
+
+protected:
+    uint16_t pixelCount;
+    Rgb16* pixels;
+    bool dirty;
+};
@@ -0,0 +1,73 @@
+#include "color-pipeline.h"
+
+ColorPipeline colorPipeline;
+
+ColorPipeline::ColorPipeline() {
+    whiteBalance[0] = LED_WHITE_BALANCE_R;
+    whiteBalance[1] = LED_WHITE_BALANCE_G;
+    whiteBalance[2] = LED_WHITE_BALANCE_B;
+    brightness = 255;
+    dithering = true;
+    setGamma(LED_GAMMA);
+    updateScale();
+}
+
+void ColorPipeline::setGamma(float gamma) {
+    for (int i = 0; i < 256; i++) {
+        gammaTable[i] = (uint16_t)(powf(i / 255.0f, gamma) * 65535.0f + 0.5f);
+    }
+}
+
+void ColorPipeline::setWhiteBalance(uint8_t r, uint8_t g, uint8_t b) {
+    whiteBalance[0] = r;
+    whiteBalance[1] = g;
+    whiteBalance[2] = b;
+    updateScale();
+}
+
+void ColorPipeline::setBrightness(uint8_t brightness) {
+    this->brightness = brightness;
+    updateScale();
+}
+
+void ColorPipeline::updateScale() {
+    for (int c = 0; c < 3; c++) {
+        channelScale[c] = ((uint32_t)brightness + 1) * (whiteBalance[c] + 1);
+    }
+}
+
+bool ColorPipeline::process(const Rgb16* in, uint32_t* out, uint8_t* residual, uint16_t count) const {
+    bool fractional = false;
+
+    for (uint16_t i = 0; i < count; i++) {
+        const uint16_t linear[3] = { in[i].r, in[i].g, in[i].b };
+        uint32_t result = 0;
+
+        // Channels from high to low byte: R, G, B
+        for (int c = 0; c < 3; c++) {
+            int shift = 16 - c * 8;
+            uint8_t& carry = residual[i * 3 + c];
+            uint32_t level = ((uint32_t)linear[c] * channelScale[c]) >> 16;
+
+            uint32_t value;
+            if (!dithering || level == 0) {
+                // Plain rounding; also keeps black black
+                value = (level + 128) >> 8;
+                carry = 0;
+            } else {
+                uint32_t sum = level + carry;
+                value = sum >> 8;
+                carry = sum & 0xFF;
+                if ((level & 0xFF) != 0) {
+                    fractional = true;
+                }
+            }
+            if (value > 255) {
+                value = 255;
+            }
+            result |= value << shift;
+        }
+        out[i] = result;
+    }
+    return fractional;
+}
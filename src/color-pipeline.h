@@ -0,0 +1,68 @@
+// color-pipeline.h - Gamma/white-balance LUT, master brightness and temporal dithering
+#pragma once
+
+#include <Arduino.h>
+
+// Gamma of the LED response; override with -DLED_GAMMA=... (1.0 = no correction)
+#ifndef LED_GAMMA
+#define LED_GAMMA 2.2
+#endif
+
+// White balance per channel, 255 = full; lower a channel to correct a colour cast
+#ifndef LED_WHITE_BALANCE_R
+#define LED_WHITE_BALANCE_R 255
+#endif
+#ifndef LED_WHITE_BALANCE_G
+#define LED_WHITE_BALANCE_G 255
+#endif
+#ifndef LED_WHITE_BALANCE_B
+#define LED_WHITE_BALANCE_B 255
+#endif
+
+// Linear light, 16 bits per channel
+struct Rgb16 {
+    uint16_t r, g, b;
+};
+
+// Converts between what effects draw and what the strip is sent. On the way in,
+// toLinear() maps 8-bit perceptual colours (0x00RRGGBB) through a gamma LUT into
+// 16-bit linear light. On the way out, process() scales the linear frame by white
+// balance and master brightness at 16 bits and reduces it to 8 bits with temporal
+// dithering: the fraction dropped in one refresh is carried to the next, so levels
+// between two 8-bit steps come out as their time average instead of banding.
+// Brightness works on the 16-bit values, so unlike NeoPixel's setBrightness() it
+// loses nothing from the frame and can be changed back at any time.
+class ColorPipeline {
+public:
+    ColorPipeline();
+
+    void setGamma(float gamma);
+    void setWhiteBalance(uint8_t r, uint8_t g, uint8_t b);
+    void setBrightness(uint8_t brightness);
+    uint8_t getBrightness() const { return brightness; }
+    void setDithering(bool enabled) { dithering = enabled; }
+    bool getDithering() const { return dithering; }
+
+    Rgb16 toLinear(uint32_t color) const {
+        return { gammaTable[(color >> 16) & 0xFF], gammaTable[(color >> 8) & 0xFF], gammaTable[color & 0xFF] };
+    }
+    Rgb16 toLinear(uint8_t r, uint8_t g, uint8_t b) const {
+        return { gammaTable[r], gammaTable[g], gammaTable[b] };
+    }
+
+    // Convert count pixels from in to out; residual holds 3 bytes per pixel of
+    // carried dither error. Returns true if any channel fell between 8-bit steps,
+    // i.e. refreshing the same frame again would improve it.
+    bool process(const Rgb16* in, uint32_t* out, uint8_t* residual, uint16_t count) const;
+
+private:
+    uint16_t gammaTable[256];  // 8-bit input -> 16-bit linear
+    uint8_t whiteBalance[3];
+    uint8_t brightness;
+    uint32_t channelScale[3];  // brightness * white balance, 0..65536
+    bool dithering;
+
+    void updateScale();
+};
+
+extern ColorPipeline colorPipeline;
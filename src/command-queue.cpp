@@ -0,0 +1,90 @@
+#include "command-queue.h"
+
+CommandQueue commandQueue;
+
+CommandQueue::CommandQueue() : head(0), tail(0) {
+    resetStats();
+}
+
+void CommandQueue::resetStats() {
+    pushed = 0;
+    applied = 0;
+    rejected = 0;
+    dropped = 0;
+    maxDepth = 0;
+    totalLatencyUs = 0;
+    maxLatencyUs = 0;
+}
+
+void CommandQueue::write(size_t& position, const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    size_t first = CAPACITY - position < length ? CAPACITY - position : length;
+    memcpy(ring + position, bytes, first);
+    memcpy(ring, bytes + first, length - first);
+    position = (position + length) % CAPACITY;
+}
+
+void CommandQueue::read(size_t& position, void* data, size_t length) const {
+    uint8_t* bytes = (uint8_t*)data;
+    size_t first = CAPACITY - position < length ? CAPACITY - position : length;
+    memcpy(bytes, ring + position, first);
+    memcpy(bytes + first, ring, length - first);
+    position = (position + length) % CAPACITY;
+}
+
+bool CommandQueue::push(const uint8_t* data, size_t length, uint32_t source) {
+    // One byte stays free so a full ring is not mistaken for an empty one
+    if (length == 0 || length > MAX_MESSAGE || used() + ENTRY_HEADER + length >= CAPACITY) {
+        dropped++;
+        return false;
+    }
+
+    size_t position = head;
+    uint16_t size = length;
+    uint32_t now = micros();
+    write(position, &size, sizeof(size));
+    write(position, &now, sizeof(now));
+    write(position, &source, sizeof(source));
+    write(position, data, length);
+    // Publish the message only once it is complete
+    head = position;
+
+    pushed++;
+    if (used() > maxDepth) {
+        maxDepth = used();
+    }
+    return true;
+}
+
+uint8_t CommandQueue::apply(ControlTarget& target, uint8_t maxCommands, RejectedHandler rejectedHandler) {
+    uint8_t count = 0;
+    while (count < maxCommands && !isEmpty()) {
+        size_t position = tail;
+        uint16_t size;
+        uint32_t pushedUs;
+        uint32_t source;
+        read(position, &size, sizeof(size));
+        read(position, &pushedUs, sizeof(pushedUs));
+        read(position, &source, sizeof(source));
+        read(position, message, size);
+        tail = position;
+
+        uint32_t latency = micros() - pushedUs;
+        totalLatencyUs += latency;
+        if (latency > maxLatencyUs) {
+            maxLatencyUs = latency;
+        }
+        applied++;
+        count++;
+
+        if (ControlProtocol::handle(target, message, size) == CONTROL_REJECTED) {
+            rejected++;
+            Serial.print("Command rejected: 0x");
+            Serial.println(message[0], HEX);
+            if (rejectedHandler) {
+                rejectedHandler(source, message, size);
+            }
+        }
+    }
+    return count;
+}
@@ -0,0 +1,68 @@
+// command-queue.h - Hands control commands from network callbacks to the loop
+#pragma once
+
+#include <Arduino.h>
+#include "control-protocol.h"
+#include "matrix-geometry.h"
+
+// The async web server runs request handlers and WebSocket events in the network
+// stack's context, in between loop iterations and at any yield(). They only validate
+// a request, encode the change as a control-protocol message and push it here; the
+// loop applies queued messages between frames, so an effect never sees a setting
+// change half-way through a frame and a slow command (the self test) never runs
+// inside a network callback.
+// Messages are stored back to back in a byte ring. Producer and consumer share the
+// one core without preempting each other, and a message is copied out before it is
+// applied, so pushes during a yielding command are safe without locking.
+class CommandQueue {
+public:
+    static const size_t CAPACITY = 2048;
+    // Largest message: a full /frame body behind its opcode
+    static const size_t MAX_MESSAGE = 2 + 3 * MATRIX_PIXELS;
+
+    // Told about a command the target refused, with the source it was pushed with
+    typedef void (*RejectedHandler)(uint32_t source, const uint8_t* message, size_t length);
+
+    CommandQueue();
+
+    // False if the message does not fit right now; the handler answers 503. source
+    // is handed back if the command is rejected (a WebSocket client id, 0 for HTTP).
+    bool push(const uint8_t* message, size_t length, uint32_t source = 0);
+    // Apply up to maxCommands queued messages in order; returns how many ran
+    uint8_t apply(ControlTarget& target, uint8_t maxCommands, RejectedHandler rejectedHandler = nullptr);
+
+    bool isEmpty() const { return head == tail; }
+
+    uint32_t getPushed() const { return pushed; }
+    uint32_t getApplied() const { return applied; }
+    uint32_t getRejected() const { return rejected; }
+    uint32_t getDropped() const { return dropped; }
+    size_t getMaxDepth() const { return maxDepth; }
+    // Time from push to applied
+    uint32_t getAverageLatencyUs() const { return applied ? totalLatencyUs / applied : 0; }
+    uint32_t getMaxLatencyUs() const { return maxLatencyUs; }
+    void resetStats();
+
+private:
+    // Ahead of every message: its length (2 bytes), the push time and the source (4 bytes each)
+    static const size_t ENTRY_HEADER = 10;
+
+    uint8_t ring[CAPACITY];
+    volatile size_t head;  // next byte to write
+    volatile size_t tail;  // next byte to read
+    uint8_t message[MAX_MESSAGE];
+
+    uint32_t pushed;
+    uint32_t applied;
+    uint32_t rejected;
+    uint32_t dropped;
+    size_t maxDepth;
+    uint64_t totalLatencyUs;
+    uint32_t maxLatencyUs;
+
+    size_t used() const { return (head + CAPACITY - tail) % CAPACITY; }
+    void write(size_t& position, const void* data, size_t length);
+    void read(size_t& position, void* data, size_t length) const;
+};
+
+extern CommandQueue commandQueue;
@@ -0,0 +1,120 @@
+#include "control-protocol.h"
+#include <string.h>
+
+static uint16_t readUint16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+ControlResult ControlProtocol::handle(ControlTarget& target, const uint8_t* data, size_t length) {
+    if (length < 1) {
+        return CONTROL_REJECTED;
+    }
+
+    const uint8_t* payload = data + 1;
+    size_t payloadLength = length - 1;
+    bool ok = false;
+
+    switch (data[0]) {
+        case CMD_SET_MODE:
+            ok = payloadLength == 1 && target.setMode(payload[0]);
+            break;
+        case CMD_SET_SPEED:
+            ok = payloadLength == 2 && target.setSpeed(readUint16(payload));
+            break;
+        case CMD_SET_COLOR:
+            if (payloadLength == 3) {
+                target.setColor(((uint32_t)payload[0] << 16) | ((uint32_t)payload[1] << 8) | payload[2]);
+                ok = true;
+            }
+            break;
+        case CMD_SET_BRIGHTNESS:
+            if (payloadLength == 1) {
+                target.setBrightness(payload[0]);
+                ok = true;
+            }
+            break;
+        case CMD_FRAME:
+            ok = target.setFrame(payload, payloadLength);
+            break;
+        case CMD_GET_STATE:
+            return payloadLength == 0 ? CONTROL_GET_STATE : CONTROL_REJECTED;
+        case CMD_SET_POWER_LIMIT:
+            ok = payloadLength == 2 && target.setPowerLimit(readUint16(payload));
+            break;
+        case CMD_SET_TRANSITION:
+            ok = payloadLength == 3 && target.setTransition(payload[0], readUint16(payload + 1));
+            break;
+        case CMD_SET_PALETTE:
+            ok = payloadLength == 2 && target.setPalette(payload[0], payload[1]);
+            break;
+        case CMD_UPLOAD_PALETTE:
+            ok = payloadLength >= 4 && payloadLength % 4 == 0 && payloadLength / 4 <= MAX_PALETTE_STOPS &&
+                 target.setCustomPalette(payload, payloadLength / 4);
+            break;
+        case CMD_SET_MARQUEE:
+            ok = length >= MARQUEE_HEADER &&
+                 target.setMarquee(payload[0], payload[1],
+                                   ((uint32_t)payload[2] << 16) | ((uint32_t)payload[3] << 8) | payload[4],
+                                   payload[5] != 0, (const char*)data + MARQUEE_HEADER, length - MARQUEE_HEADER);
+            break;
+        case CMD_SET_PIXEL:
+            ok = payloadLength == 3 && target.setPixel(payload[0], payload[1], payload[2] != 0);
+            break;
+        case CMD_CLEAR_GRID:
+            if ((ok = payloadLength == 0)) target.clearGrid();
+            break;
+        case CMD_FILL_GRID:
+            if ((ok = payloadLength == 0)) target.fillGrid();
+            break;
+        case CMD_DRAW_BORDER:
+            if ((ok = payloadLength == 0)) target.drawBorder();
+            break;
+        case CMD_RESET_STATS:
+            if ((ok = payloadLength == 0)) target.resetStats();
+            break;
+        case CMD_SELF_TEST:
+            if ((ok = payloadLength == 1)) target.runSelfTest(payload[0] != 0);
+            break;
+        case CMD_RESET_WIFI:
+            if ((ok = payloadLength == 0)) target.resetWiFi();
+            break;
+        default:
+            break;
+    }
+    return ok ? CONTROL_DONE : CONTROL_REJECTED;
+}
+
+size_t ControlProtocol::encodeState(const ControlState& state, uint8_t* out) {
+    out[0] = MSG_STATE;
+    out[1] = state.mode;
+    out[2] = state.speed & 0xFF;
+    out[3] = state.speed >> 8;
+    out[4] = state.brightness;
+    out[5] = (state.color >> 16) & 0xFF;
+    out[6] = (state.color >> 8) & 0xFF;
+    out[7] = state.color & 0xFF;
+
+    size_t nameLength = state.name ? strlen(state.name) : 0;
+    if (nameLength > MAX_NAME_LENGTH) {
+        nameLength = MAX_NAME_LENGTH;
+    }
+    if (nameLength) {
+        memcpy(out + STATE_HEADER, state.name, nameLength);
+    }
+    return STATE_HEADER + nameLength;
+}
+
+size_t ControlProtocol::encodeSensor(const SensorReading& reading, uint8_t* out) {
+    out[0] = MSG_SENSOR;
+    out[1] = (uint16_t)reading.temperatureTenths & 0xFF;
+    out[2] = (uint16_t)reading.temperatureTenths >> 8;
+    out[3] = (uint16_t)reading.humidityTenths & 0xFF;
+    out[4] = (uint16_t)reading.humidityTenths >> 8;
+    return SENSOR_LENGTH;
+}
+
+size_t ControlProtocol::encodeError(const uint8_t* command, size_t length, uint8_t* out) {
+    out[0] = MSG_ERROR;
+    out[1] = length > 0 ? command[0] : 0;
+    return ERROR_LENGTH;
+}
@@ -0,0 +1,128 @@
+// control-protocol.h - Binary messages of the WebSocket control channel
+#pragma once
+
+// Plain C++ only (no Arduino headers), so the protocol builds natively as well
+#include <stdint.h>
+#include <stddef.h>
+
+// First byte of every message. Commands go from a client to the device, the
+// 0x80 range from the device to clients. Multi-byte numbers are little-endian.
+enum ControlOpcode : uint8_t {
+    CMD_SET_MODE = 0x01,        // mode
+    CMD_SET_SPEED = 0x02,       // speed multiplier in 8.8 fixed point (uint16), 51-768 (0.2-3.0)
+    CMD_SET_COLOR = 0x03,       // R, G, B
+    CMD_SET_BRIGHTNESS = 0x04,  // brightness 0-255
+    CMD_FRAME = 0x05,           // a POST /frame body (type byte, then pixels or runs)
+    CMD_GET_STATE = 0x06,       // no payload; answered with MSG_STATE and MSG_SENSOR
+    CMD_SET_POWER_LIMIT = 0x07, // limit in mA (uint16), 500-15000
+    CMD_SET_TRANSITION = 0x08,  // style (TransitionStyle, 0xFF unchanged), duration ms (uint16, 0xFFFF unchanged)
+    CMD_SET_PALETTE = 0x09,     // mode, palette (PaletteId)
+    CMD_UPLOAD_PALETTE = 0x0A,  // 1-16 stops of position, R, G, B
+    CMD_SET_MARQUEE = 0x0B,     // fields (MarqueeField bits), speed, R, G, B, smooth, text (UTF-8, rest of message)
+    CMD_SET_PIXEL = 0x0C,       // col, row, on (0/1); lit pixels take the selected colour
+    CMD_CLEAR_GRID = 0x0D,      // no payload
+    CMD_FILL_GRID = 0x0E,       // no payload; every pixel in the selected colour
+    CMD_DRAW_BORDER = 0x0F,     // no payload; clear, then the outline in the selected colour
+    CMD_RESET_STATS = 0x10,     // no payload
+    CMD_SELF_TEST = 0x11,       // rebaseline (0/1)
+    CMD_RESET_WIFI = 0x12,      // no payload; forget the network and restart (HTTP only, sockets get MSG_ERROR)
+
+    MSG_STATE = 0x81,           // mode, speed (8.8, uint16), brightness, R, G, B, mode name (UTF-8, rest of message)
+    MSG_SENSOR = 0x82,          // temperature and humidity in tenths, int16 each; -9990 if unknown
+    MSG_ERROR = 0x83            // opcode of the rejected command
+};
+
+// Which parts of CMD_SET_MARQUEE to apply
+enum MarqueeField : uint8_t {
+    MARQUEE_TEXT = 0x01,
+    MARQUEE_SPEED = 0x02,
+    MARQUEE_COLOR = 0x04,
+    MARQUEE_SMOOTH = 0x08
+};
+
+// What state messages report; name is not compared, it follows mode
+struct ControlState {
+    uint8_t mode;
+    uint16_t speed;  // 8.8 fixed point
+    uint8_t brightness;
+    uint32_t color;  // 0x00RRGGBB
+    const char* name;
+
+    bool operator==(const ControlState& other) const {
+        return mode == other.mode && speed == other.speed &&
+               brightness == other.brightness && color == other.color;
+    }
+    bool operator!=(const ControlState& other) const { return !(*this == other); }
+};
+
+struct SensorReading {
+    int16_t temperatureTenths;
+    int16_t humidityTenths;
+
+    bool operator==(const SensorReading& other) const {
+        return temperatureTenths == other.temperatureTenths && humidityTenths == other.humidityTenths;
+    }
+    bool operator!=(const SensorReading& other) const { return !(*this == other); }
+};
+
+// What commands act on. The firmware implements it on its globals; a native build
+// supplies its own to exercise the protocol without the device.
+class ControlTarget {
+public:
+    virtual ~ControlTarget() {}
+    // False if the value is out of range; nothing is changed then
+    virtual bool setMode(uint8_t mode) = 0;
+    virtual bool setSpeed(uint16_t speed) = 0;
+    virtual void setColor(uint32_t color) = 0;
+    virtual void setBrightness(uint8_t brightness) = 0;
+    virtual bool setFrame(const uint8_t* data, size_t length) = 0;
+    virtual bool setPowerLimit(uint16_t milliamps) = 0;
+    // style KEEP_STYLE or durationMs KEEP_DURATION leaves that part as it is
+    virtual bool setTransition(uint8_t style, uint16_t durationMs) = 0;
+    virtual bool setPalette(uint8_t mode, uint8_t palette) = 0;
+    // count stops of 4 bytes: position, R, G, B
+    virtual bool setCustomPalette(const uint8_t* stops, uint8_t count) = 0;
+    // Only the parts named in fields are applied; text is not NUL-terminated
+    virtual bool setMarquee(uint8_t fields, uint8_t speed, uint32_t color, bool smooth,
+                            const char* text, size_t textLength) = 0;
+    virtual bool setPixel(uint8_t col, uint8_t row, bool on) = 0;
+    virtual void clearGrid() = 0;
+    virtual void fillGrid() = 0;
+    virtual void drawBorder() = 0;
+    virtual void resetStats() = 0;
+    virtual void runSelfTest(bool rebaseline) = 0;
+    virtual void resetWiFi() = 0;
+
+    static const uint8_t KEEP_STYLE = 0xFF;
+    static const uint16_t KEEP_DURATION = 0xFFFF;
+};
+
+enum ControlResult : uint8_t {
+    CONTROL_DONE,       // command applied; state changes reach clients as MSG_STATE
+    CONTROL_GET_STATE,  // the sender wants the current state
+    CONTROL_REJECTED    // unknown opcode, wrong length or value; answer with MSG_ERROR
+};
+
+class ControlProtocol {
+public:
+    static const size_t MAX_NAME_LENGTH = 32;
+    static const size_t STATE_HEADER = 8;  // opcode to blue, before the name
+    static const size_t MAX_STATE_LENGTH = STATE_HEADER + MAX_NAME_LENGTH;
+    // Speed multiplier in 8.8 fixed point, as the frame clock applies it
+    static const uint16_t MIN_SPEED = 51;   // 0.2
+    static const uint16_t MAX_SPEED = 768;  // 3.0
+    static const size_t SENSOR_LENGTH = 5;
+    static const size_t ERROR_LENGTH = 2;
+    static const int16_t UNKNOWN_READING = -9990;
+    static const uint8_t MAX_PALETTE_STOPS = 16;
+    static const size_t MARQUEE_HEADER = 7;  // opcode to smooth, before the text
+
+    // Decode one client message and apply it to target
+    static ControlResult handle(ControlTarget& target, const uint8_t* data, size_t length);
+
+    // Encode device messages into out (at least the matching *_LENGTH bytes); each
+    // returns the message length
+    static size_t encodeState(const ControlState& state, uint8_t* out);
+    static size_t encodeSensor(const SensorReading& reading, uint8_t* out);
+    static size_t encodeError(const uint8_t* command, size_t length, uint8_t* out);
+};
@@ -0,0 +1,65 @@
+// effect-arena.h - Shared blocks of RAM holding the state of the running effects
+#pragma once
+
+#include <Arduino.h>
+#include <new>
+
+// Effects keep their working buffers in a State struct that is constructed here on
+// begin() and destroyed on end(), so only the running effects' state occupies RAM.
+// Size is the largest State of all effects; create() refuses at compile time any
+// state that does not fit. Slots is how many effects may run at once (two while
+// Auto Cycle transitions from one effect into the next).
+template<size_t Size, uint8_t Slots = 1>
+class EffectArena {
+public:
+    EffectArena() {
+        for (uint8_t i = 0; i < Slots; i++) {
+            used[i] = 0;
+            destroyer[i] = nullptr;
+        }
+    }
+
+    // Construct a zero-initialised T in a free slot; nullptr when every slot is taken
+    template<typename T>
+    T* create() {
+        static_assert(sizeof(T) <= Size, "effect state does not fit the arena, raise its size");
+        static_assert(alignof(T) <= alignof(uint32_t), "effect state needs stricter alignment than the arena");
+        uint8_t slot = 0;
+        while (slot < Slots && destroyer[slot]) slot++;
+        if (slot == Slots) return nullptr;
+        T* object = new (storage[slot]) T();
+        used[slot] = sizeof(T);
+        destroyer[slot] = [](void* p) { static_cast<T*>(p)->~T(); };
+        return object;
+    }
+
+    // End the state create() returned
+    void release(const void* object) {
+        for (uint8_t i = 0; i < Slots; i++) {
+            if (object == storage[i]) releaseSlot(i);
+        }
+    }
+
+    static constexpr size_t size() { return SLOT_SIZE * Slots; }
+    size_t getUsed() const {
+        size_t total = 0;
+        for (uint8_t i = 0; i < Slots; i++) total += used[i];
+        return total;
+    }
+
+private:
+    // Slot size rounded up so every slot stays word aligned
+    static const size_t SLOT_SIZE = (Size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+
+    alignas(uint32_t) uint8_t storage[Slots][SLOT_SIZE];
+    size_t used[Slots];
+    void (*destroyer[Slots])(void*);
+
+    void releaseSlot(uint8_t slot) {
+        if (destroyer[slot]) {
+            destroyer[slot](storage[slot]);
+            destroyer[slot] = nullptr;
+        }
+        used[slot] = 0;
+    }
+};
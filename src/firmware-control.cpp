@@ -0,0 +1,202 @@
+#include "firmware-control.h"
+#include "webserver.h"
+#include "animation.h"
+#include "color-pipeline.h"
+#include "framebuffer.h"
+#include "power-limiter.h"
+#include "transition.h"
+#include "palette.h"
+#include "marquee.h"
+#include "frame-profiler.h"
+#include "scheduler.h"
+#include "self-test.h"
+#include "wifi-config-manager.h"
+#include "command-queue.h"
+
+FirmwareControl firmwareControl;
+
+bool FirmwareControl::setMode(uint8_t mode) {
+    if (!AnimationRegistry::get(mode)) {
+        return false;
+    }
+    currentAnimation = (AnimationMode)mode;
+    animationChanged = true;
+    Serial.print("Animation changed to: ");
+    Serial.println(getAnimationName(currentAnimation));
+    return true;
+}
+
+bool FirmwareControl::setSpeed(uint16_t speed) {
+    if (speed < ControlProtocol::MIN_SPEED || speed > ControlProtocol::MAX_SPEED) {
+        return false;
+    }
+    // Exact in a float, so the frame clock gets back the same 8.8 value
+    animationSpeed = speed / 256.0f;
+    Serial.print("Animation speed changed to: ");
+    Serial.println(animationSpeed);
+    return true;
+}
+
+void FirmwareControl::setColor(uint32_t color) {
+    selectedColor = color;
+    Serial.print("Color changed to: #");
+    Serial.println(color, HEX);
+}
+
+void FirmwareControl::setBrightness(uint8_t brightness) {
+    colorPipeline.setBrightness(brightness);
+    frameBuffer.invalidate();
+    Serial.print("Brightness changed to: ");
+    Serial.println(brightness);
+}
+
+bool FirmwareControl::setFrame(const uint8_t* data, size_t length) {
+    return setDrawingFrame(data, length);
+}
+
+bool FirmwareControl::setPowerLimit(uint16_t milliamps) {
+    if (milliamps < PowerLimiter::MIN_LIMIT_MA || milliamps > PowerLimiter::MAX_LIMIT_MA) {
+        return false;
+    }
+    powerLimiter.setLimit(milliamps);
+    Serial.print("Power limit changed to: ");
+    Serial.println(milliamps);
+    return true;
+}
+
+bool FirmwareControl::setTransition(uint8_t style, uint16_t durationMs) {
+    if ((style != KEEP_STYLE && style > TRANSITION_WIPE) ||
+        (durationMs != KEEP_DURATION && durationMs > 5000)) {
+        return false;
+    }
+    if (style != KEEP_STYLE) {
+        transition.setStyle((TransitionStyle)style);
+    }
+    if (durationMs != KEEP_DURATION) {
+        transition.setDuration(durationMs);
+    }
+    Serial.print("Transition set to: ");
+    Serial.print(Transition::styleName(transition.getStyle()));
+    Serial.print(", ");
+    Serial.print(transition.getDuration());
+    Serial.println(" ms");
+    return true;
+}
+
+bool FirmwareControl::setPalette(uint8_t mode, uint8_t palette) {
+    if (!AnimationRegistry::get(mode) || palette >= PALETTE_COUNT) {
+        return false;
+    }
+    palettes.assign((AnimationMode)mode, (PaletteId)palette);
+    Serial.print(getAnimationName((AnimationMode)mode));
+    Serial.print(" palette set to: ");
+    Serial.println(PaletteBank::getName((PaletteId)palette));
+    return true;
+}
+
+bool FirmwareControl::setCustomPalette(const uint8_t* stops, uint8_t count) {
+    if (count > Palette::MAX_STOPS) {
+        return false;
+    }
+    PaletteStop decoded[Palette::MAX_STOPS];
+    for (uint8_t i = 0; i < count; i++, stops += 4) {
+        decoded[i].position = stops[0];
+        decoded[i].color = ((uint32_t)stops[1] << 16) | ((uint32_t)stops[2] << 8) | stops[3];
+    }
+    if (!palettes.setCustom(decoded, count)) {
+        return false;
+    }
+    Serial.print("Custom palette set from ");
+    Serial.print(count);
+    Serial.println(" stops");
+    return true;
+}
+
+bool FirmwareControl::setMarquee(uint8_t fields, uint8_t speed, uint32_t color, bool smooth,
+                                 const char* text, size_t textLength) {
+    if ((fields & MARQUEE_SPEED) && (speed < 1 || speed > 60)) {
+        return false;
+    }
+    if (fields & MARQUEE_TEXT) {
+        // Up to four UTF-8 bytes per character
+        char message[Marquee::MAX_TEXT_LENGTH * 4 + 1];
+        if (textLength >= sizeof(message)) {
+            return false;
+        }
+        memcpy(message, text, textLength);
+        message[textLength] = 0;
+        if (!marquee.setText(message)) {
+            return false;
+        }
+    }
+    if (fields & MARQUEE_SPEED) {
+        marquee.setSpeed(speed);
+    }
+    if (fields & MARQUEE_COLOR) {
+        marquee.setColor(color);
+    }
+    if (fields & MARQUEE_SMOOTH) {
+        marquee.setSmooth(smooth);
+    }
+    Serial.print("Marquee set to: ");
+    Serial.println(marquee.getText());
+    return true;
+}
+
+bool FirmwareControl::setPixel(uint8_t col, uint8_t row, bool on) {
+    if (!DisplayGeometry::inBounds(col, row)) {
+        return false;
+    }
+    setDrawingPixel(col, row, on);
+    return true;
+}
+
+void FirmwareControl::clearGrid() {
+    clearDrawingGrid();
+}
+
+void FirmwareControl::fillGrid() {
+    for (int col = 0; col < MATRIX_COLS; col++) {
+        for (int row = 0; row < MATRIX_ROWS; row++) {
+            drawingGrid[col][row] = selectedColor;  // Use current selected color
+        }
+    }
+}
+
+void FirmwareControl::drawBorder() {
+    clearDrawingGrid();
+    for (int col = 0; col < MATRIX_COLS; col++) {
+        for (int row = 0; row < MATRIX_ROWS; row++) {
+            if (row == 0 || row == MATRIX_ROWS - 1 || col == 0 || col == MATRIX_COLS - 1) {
+                drawingGrid[col][row] = selectedColor;  // Use current selected color
+            }
+        }
+    }
+}
+
+void FirmwareControl::resetStats() {
+    frameProfiler.reset();
+    scheduler.resetStats();
+    commandQueue.resetStats();
+    Serial.println("Stats reset");
+}
+
+void FirmwareControl::runSelfTest(bool rebaseline) {
+    // The render task replays the suite a few frames per slice from here on
+    SelfTest::start(rebaseline);
+}
+
+void FirmwareControl::resetWiFi() {
+    // Forget the network now, restart once the response had time to reach the client
+    wifiConfigManager.clearConfig();
+    restartPending = true;
+    restartRequestedMs = millis();
+    Serial.println("WiFi configuration reset. Restarting shortly...");
+}
+
+void FirmwareControl::poll() {
+    if (restartPending && millis() - restartRequestedMs >= RESTART_DELAY_MS) {
+        Serial.println("Restarting...");
+        ESP.restart();
+    }
+}
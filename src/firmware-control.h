@@ -0,0 +1,44 @@
+// firmware-control.h - Control commands applied to the firmware's settings
+#pragma once
+
+#include <Arduino.h>
+#include "control-protocol.h"
+
+// The one place where commands from the web server and the WebSocket channel
+// change the running settings. Calls come from the loop (the command queue), never
+// from network callbacks, so they are free to touch the
+// effects, the drawing grid and the output pipeline.
+class FirmwareControl : public ControlTarget {
+public:
+    bool setMode(uint8_t mode) override;
+    bool setSpeed(uint16_t speed) override;
+    void setColor(uint32_t color) override;
+    void setBrightness(uint8_t brightness) override;
+    bool setFrame(const uint8_t* data, size_t length) override;
+    bool setPowerLimit(uint16_t milliamps) override;
+    bool setTransition(uint8_t style, uint16_t durationMs) override;
+    bool setPalette(uint8_t mode, uint8_t palette) override;
+    bool setCustomPalette(const uint8_t* stops, uint8_t count) override;
+    bool setMarquee(uint8_t fields, uint8_t speed, uint32_t color, bool smooth,
+                    const char* text, size_t textLength) override;
+    bool setPixel(uint8_t col, uint8_t row, bool on) override;
+    void clearGrid() override;
+    void fillGrid() override;
+    void drawBorder() override;
+    void resetStats() override;
+    void runSelfTest(bool rebaseline) override;
+    void resetWiFi() override;
+
+    // Carry out what commands left for later, i.e. the restart after a WiFi reset;
+    // the http task calls it after applying the queued commands
+    void poll();
+
+private:
+    // Time for the command's HTTP answer to reach the client before the restart
+    static const unsigned long RESTART_DELAY_MS = 1000;
+
+    bool restartPending = false;
+    unsigned long restartRequestedMs = 0;
+};
+
+extern FirmwareControl firmwareControl;
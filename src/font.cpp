@@ -0,0 +1,269 @@
+#include "font.h"
+#include "matrix-geometry.h"
+
+// Column-major, one byte per column, bit 0 = top row. ASCII 32..126, then '\x7f' as
+// the degree sign.
+static const uint8_t FONT_5X7_DATA[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x00, 0x00,  // space
+    0x00, 0x00, 0x5F, 0x00, 0x00,  // !
+    0x00, 0x07, 0x00, 0x07, 0x00,  // "
+    0x14, 0x7F, 0x14, 0x7F, 0x14,  // #
+    0x24, 0x2A, 0x7F, 0x2A, 0x12,  // $
+    0x23, 0x13, 0x08, 0x64, 0x62,  // %
+    0x36, 0x49, 0x55, 0x22, 0x50,  // &
+    0x00, 0x05, 0x03, 0x00, 0x00,  // '
+    0x00, 0x1C, 0x22, 0x41, 0x00,  // (
+    0x00, 0x41, 0x22, 0x1C, 0x00,  // )
+    0x14, 0x08, 0x3E, 0x08, 0x14,  // *
+    0x08, 0x08, 0x3E, 0x08, 0x08,  // +
+    0x00, 0x50, 0x30, 0x00, 0x00,  // ,
+    0x08, 0x08, 0x08, 0x08, 0x08,  // -
+    0x00, 0x60, 0x60, 0x00, 0x00,  // .
+    0x20, 0x10, 0x08, 0x04, 0x02,  // /
+    0x3E, 0x51, 0x49, 0x45, 0x3E,  // 0
+    0x00, 0x42, 0x7F, 0x40, 0x00,  // 1
+    0x42, 0x61, 0x51, 0x49, 0x46,  // 2
+    0x21, 0x41, 0x45, 0x4B, 0x31,  // 3
+    0x18, 0x14, 0x12, 0x7F, 0x10,  // 4
+    0x27, 0x45, 0x45, 0x45, 0x39,  // 5
+    0x3C, 0x4A, 0x49, 0x49, 0x30,  // 6
+    0x01, 0x71, 0x09, 0x05, 0x03,  // 7
+    0x36, 0x49, 0x49, 0x49, 0x36,  // 8
+    0x06, 0x49, 0x49, 0x29, 0x1E,  // 9
+    0x00, 0x36, 0x36, 0x00, 0x00,  // :
+    0x00, 0x56, 0x36, 0x00, 0x00,  // ;
+    0x08, 0x14, 0x22, 0x41, 0x00,  // <
+    0x14, 0x14, 0x14, 0x14, 0x14,  // =
+    0x00, 0x41, 0x22, 0x14, 0x08,  // >
+    0x02, 0x01, 0x51, 0x09, 0x06,  // ?
+    0x32, 0x49, 0x79, 0x41, 0x3E,  // @
+    0x7E, 0x11, 0x11, 0x11, 0x7E,  // A
+    0x7F, 0x49, 0x49, 0x49, 0x36,  // B
+    0x3E, 0x41, 0x41, 0x41, 0x22,  // C
+    0x7F, 0x41, 0x41, 0x22, 0x1C,  // D
+    0x7F, 0x49, 0x49, 0x49, 0x41,  // E
+    0x7F, 0x09, 0x09, 0x09, 0x01,  // F
+    0x3E, 0x41, 0x49, 0x49, 0x7A,  // G
+    0x7F, 0x08, 0x08, 0x08, 0x7F,  // H
+    0x00, 0x41, 0x7F, 0x41, 0x00,  // I
+    0x20, 0x40, 0x41, 0x3F, 0x01,  // J
+    0x7F, 0x08, 0x14, 0x22, 0x41,  // K
+    0x7F, 0x40, 0x40, 0x40, 0x40,  // L
+    0x7F, 0x02, 0x0C, 0x02, 0x7F,  // M
+    0x7F, 0x04, 0x08, 0x10, 0x7F,  // N
+    0x3E, 0x41, 0x41, 0x41, 0x3E,  // O
+    0x7F, 0x09, 0x09, 0x09, 0x06,  // P
+    0x3E, 0x41, 0x51, 0x21, 0x5E,  // Q
+    0x7F, 0x09, 0x19, 0x29, 0x46,  // R
+    0x46, 0x49, 0x49, 0x49, 0x31,  // S
+    0x01, 0x01, 0x7F, 0x01, 0x01,  // T
+    0x3F, 0x40, 0x40, 0x40, 0x3F,  // U
+    0x1F, 0x20, 0x40, 0x20, 0x1F,  // V
+    0x3F, 0x40, 0x38, 0x40, 0x3F,  // W
+    0x63, 0x14, 0x08, 0x14, 0x63,  // X
+    0x07, 0x08, 0x70, 0x08, 0x07,  // Y
+    0x61, 0x51, 0x49, 0x45, 0x43,  // Z
+    0x00, 0x7F, 0x41, 0x41, 0x00,  // [
+    0x02, 0x04, 0x08, 0x10, 0x20,  // backslash
+    0x00, 0x41, 0x41, 0x7F, 0x00,  // ]
+    0x04, 0x02, 0x01, 0x02, 0x04,  // ^
+    0x40, 0x40, 0x40, 0x40, 0x40,  // _
+    0x00, 0x01, 0x02, 0x04, 0x00,  // `
+    0x20, 0x54, 0x54, 0x54, 0x78,  // a
+    0x7F, 0x48, 0x44, 0x44, 0x38,  // b
+    0x38, 0x44, 0x44, 0x44, 0x20,  // c
+    0x38, 0x44, 0x44, 0x48, 0x7F,  // d
+    0x38, 0x54, 0x54, 0x54, 0x18,  // e
+    0x08, 0x7E, 0x09, 0x01, 0x02,  // f
+    0x0C, 0x52, 0x52, 0x52, 0x3E,  // g
+    0x7F, 0x08, 0x04, 0x04, 0x78,  // h
+    0x00, 0x44, 0x7D, 0x40, 0x00,  // i
+    0x20, 0x40, 0x44, 0x3D, 0x00,  // j
+    0x7F, 0x10, 0x28, 0x44, 0x00,  // k
+    0x00, 0x41, 0x7F, 0x40, 0x00,  // l
+    0x7C, 0x04, 0x18, 0x04, 0x78,  // m
+    0x7C, 0x08, 0x04, 0x04, 0x78,  // n
+    0x38, 0x44, 0x44, 0x44, 0x38,  // o
+    0x7C, 0x14, 0x14, 0x14, 0x08,  // p
+    0x08, 0x14, 0x14, 0x18, 0x7C,  // q
+    0x7C, 0x08, 0x04, 0x04, 0x08,  // r
+    0x48, 0x54, 0x54, 0x54, 0x20,  // s
+    0x04, 0x3F, 0x44, 0x40, 0x20,  // t
+    0x3C, 0x40, 0x40, 0x20, 0x7C,  // u
+    0x1C, 0x20, 0x40, 0x20, 0x1C,  // v
+    0x3C, 0x40, 0x30, 0x40, 0x3C,  // w
+    0x44, 0x28, 0x10, 0x28, 0x44,  // x
+    0x0C, 0x50, 0x50, 0x50, 0x3C,  // y
+    0x44, 0x64, 0x54, 0x4C, 0x44,  // z
+    0x00, 0x08, 0x36, 0x41, 0x00,  // {
+    0x00, 0x00, 0x7F, 0x00, 0x00,  // |
+    0x00, 0x41, 0x36, 0x08, 0x00,  // }
+    0x08, 0x04, 0x08, 0x10, 0x08,  // ~
+    0x00, 0x06, 0x09, 0x09, 0x06,  // degree
+};
+
+// Lowercase letters repeat the capitals; 3x5 has no room for both
+static const uint8_t FONT_3X5_DATA[] PROGMEM = {
+    0x00, 0x00, 0x00,  // space
+    0x00, 0x17, 0x00,  // !
+    0x03, 0x00, 0x03,  // "
+    0x1F, 0x0A, 0x1F,  // #
+    0x12, 0x1F, 0x09,  // $
+    0x19, 0x04, 0x13,  // %
+    0x0A, 0x15, 0x1A,  // &
+    0x00, 0x03, 0x00,  // '
+    0x00, 0x0E, 0x11,  // (
+    0x11, 0x0E, 0x00,  // )
+    0x0A, 0x04, 0x0A,  // *
+    0x04, 0x0E, 0x04,  // +
+    0x10, 0x08, 0x00,  // ,
+    0x04, 0x04, 0x04,  // -
+    0x00, 0x10, 0x00,  // .
+    0x18, 0x04, 0x03,  // /
+    0x1F, 0x11, 0x1F,  // 0
+    0x12, 0x1F, 0x10,  // 1
+    0x1D, 0x15, 0x17,  // 2
+    0x11, 0x15, 0x1F,  // 3
+    0x07, 0x04, 0x1F,  // 4
+    0x17, 0x15, 0x1D,  // 5
+    0x1F, 0x15, 0x1D,  // 6
+    0x01, 0x1D, 0x03,  // 7
+    0x1F, 0x15, 0x1F,  // 8
+    0x17, 0x15, 0x1F,  // 9
+    0x00, 0x0A, 0x00,  // :
+    0x10, 0x0A, 0x00,  // ;
+    0x04, 0x0A, 0x11,  // <
+    0x0A, 0x0A, 0x0A,  // =
+    0x11, 0x0A, 0x04,  // >
+    0x01, 0x15, 0x07,  // ?
+    0x1F, 0x15, 0x17,  // @
+    0x1E, 0x05, 0x1E,  // A
+    0x1F, 0x15, 0x0A,  // B
+    0x0E, 0x11, 0x11,  // C
+    0x1F, 0x11, 0x0E,  // D
+    0x1F, 0x15, 0x11,  // E
+    0x1F, 0x05, 0x01,  // F
+    0x0E, 0x11, 0x1D,  // G
+    0x1F, 0x04, 0x1F,  // H
+    0x11, 0x1F, 0x11,  // I
+    0x08, 0x10, 0x0F,  // J
+    0x1F, 0x04, 0x1B,  // K
+    0x1F, 0x10, 0x10,  // L
+    0x1F, 0x06, 0x1F,  // M
+    0x1F, 0x01, 0x1E,  // N
+    0x0E, 0x11, 0x0E,  // O
+    0x1F, 0x05, 0x02,  // P
+    0x0E, 0x19, 0x16,  // Q
+    0x1F, 0x05, 0x1A,  // R
+    0x12, 0x15, 0x09,  // S
+    0x01, 0x1F, 0x01,  // T
+    0x1F, 0x10, 0x1F,  // U
+    0x0F, 0x10, 0x0F,  // V
+    0x1F, 0x0C, 0x1F,  // W
+    0x1B, 0x04, 0x1B,  // X
+    0x03, 0x1C, 0x03,  // Y
+    0x19, 0x15, 0x13,  // Z
+    0x1F, 0x11, 0x00,  // [
+    0x03, 0x04, 0x18,  // backslash
+    0x00, 0x11, 0x1F,  // ]
+    0x02, 0x01, 0x02,  // ^
+    0x10, 0x10, 0x10,  // _
+    0x01, 0x02, 0x00,  // `
+    0x1E, 0x05, 0x1E,  // a
+    0x1F, 0x15, 0x0A,  // b
+    0x0E, 0x11, 0x11,  // c
+    0x1F, 0x11, 0x0E,  // d
+    0x1F, 0x15, 0x11,  // e
+    0x1F, 0x05, 0x01,  // f
+    0x0E, 0x11, 0x1D,  // g
+    0x1F, 0x04, 0x1F,  // h
+    0x11, 0x1F, 0x11,  // i
+    0x08, 0x10, 0x0F,  // j
+    0x1F, 0x04, 0x1B,  // k
+    0x1F, 0x10, 0x10,  // l
+    0x1F, 0x06, 0x1F,  // m
+    0x1F, 0x01, 0x1E,  // n
+    0x0E, 0x11, 0x0E,  // o
+    0x1F, 0x05, 0x02,  // p
+    0x0E, 0x19, 0x16,  // q
+    0x1F, 0x05, 0x1A,  // r
+    0x12, 0x15, 0x09,  // s
+    0x01, 0x1F, 0x01,  // t
+    0x1F, 0x10, 0x1F,  // u
+    0x0F, 0x10, 0x0F,  // v
+    0x1F, 0x0C, 0x1F,  // w
+    0x1B, 0x04, 0x1B,  // x
+    0x03, 0x1C, 0x03,  // y
+    0x19, 0x15, 0x13,  // z
+    0x04, 0x1B, 0x11,  // {
+    0x00, 0x1F, 0x00,  // |
+    0x11, 0x1B, 0x04,  // }
+    0x0C, 0x04, 0x06,  // ~
+    0x02, 0x05, 0x02,  // degree
+};
+
+const Font FONT_5X7 = { 5, 7, 32, 127, 1, 3, FONT_5X7_DATA };
+const Font FONT_3X5 = { 3, 5, 32, 127, 1, 2, FONT_3X5_DATA };
+
+static const uint8_t* glyphData(const Font& font, char c) {
+    uint8_t code = (uint8_t)c;
+    if (code < font.first || code > font.last) {
+        code = '?';
+    }
+    return font.data + (code - font.first) * font.width;
+}
+
+uint8_t Text::glyphColumn(const Font& font, char c, uint8_t column) {
+    return column < font.width ? pgm_read_byte(glyphData(font, c) + column) : 0;
+}
+
+uint8_t Text::glyphWidth(const Font& font, char c, uint8_t* start) {
+    const uint8_t* glyph = glyphData(font, c);
+    uint8_t first = 0;
+    uint8_t last = font.width;
+    while (first < last && pgm_read_byte(glyph + first) == 0) first++;
+    while (last > first && pgm_read_byte(glyph + last - 1) == 0) last--;
+    if (start) *start = first;
+    if (first == last) {
+        // Blank glyph: only the space has a width
+        return c == ' ' ? font.spaceWidth : 0;
+    }
+    return last - first;
+}
+
+uint16_t Text::measure(const Font& font, const char* text) {
+    uint16_t width = 0;
+    for (const char* p = text; *p; p++) {
+        if (p != text) width += font.spacing;
+        width += glyphWidth(font, *p);
+    }
+    return width;
+}
+
+uint8_t Text::drawGlyph(Canvas& canvas, const Font& font, char c, int16_t x, int16_t y, const Rgb16& color) {
+    uint8_t start;
+    uint8_t width = glyphWidth(font, c, &start);
+    const uint8_t* glyph = glyphData(font, c) + start;
+
+    for (uint8_t i = 0; i < width; i++) {
+        int16_t col = x + i;
+        if (col < 0 || col >= MATRIX_COLS) continue;
+        uint8_t bits = pgm_read_byte(glyph + i);
+        // Walk the column through the index table, one row stride at a time
+        for (int16_t row = y; bits; row++, bits >>= 1) {
+            if ((bits & 1) && row >= 0 && row < MATRIX_ROWS) {
+                canvas.setPixel(DisplayGeometry::table.index[row * MATRIX_COLS + col], color);
+            }
+        }
+    }
+    return width;
+}
+
+int16_t Text::draw(Canvas& canvas, const Font& font, const char* text, int16_t x, int16_t y, uint32_t color) {
+    // One gamma conversion for the whole string
+    Rgb16 linear = colorPipeline.toLinear(color);
+    for (const char* p = text; *p; p++) {
+        x += drawGlyph(canvas, font, *p, x, y, linear) + font.spacing;
+    }
+    return x;
+}
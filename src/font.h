@@ -0,0 +1,41 @@
+// font.h - Packed 1-bpp bitmap fonts in flash and a text renderer for the canvas
+#pragma once
+
+#include <Arduino.h>
+#include "canvas.h"
+
+// Glyphs are stored column by column, one byte per column with bit 0 at the top, so
+// a glyph is blitted a whole column at a time. Characters outside first..last draw
+// as '?'. Glyphs are proportional: blank columns at either side are trimmed when
+// measuring and drawing.
+struct Font {
+    uint8_t width;        // columns per glyph in the table
+    uint8_t height;       // rows
+    uint8_t first;        // first and last character in the table
+    uint8_t last;
+    uint8_t spacing;      // blank columns between glyphs
+    uint8_t spaceWidth;   // advance of ' ', which has no columns to measure
+    const uint8_t* data;  // PROGMEM
+};
+
+extern const Font FONT_5X7;
+extern const Font FONT_3X5;
+
+// Both fonts carry a degree sign in place of DEL
+const char FONT_DEGREE = '\x7f';
+
+class Text {
+public:
+    // Width of c after trimming; start receives its first non-blank column
+    static uint8_t glyphWidth(const Font& font, char c, uint8_t* start = nullptr);
+    // One column of c as stored (bit 0 = top row)
+    static uint8_t glyphColumn(const Font& font, char c, uint8_t column);
+
+    // Width of text in columns, without trailing spacing
+    static uint16_t measure(const Font& font, const char* text);
+
+    // Draw c with its top-left at (x, y), clipped to the matrix; returns its width
+    static uint8_t drawGlyph(Canvas& canvas, const Font& font, char c, int16_t x, int16_t y, const Rgb16& color);
+    // Draw text from (x, y); returns the x where the next glyph would start
+    static int16_t draw(Canvas& canvas, const Font& font, const char* text, int16_t x, int16_t y, uint32_t color);
+};
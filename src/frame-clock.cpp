@@ -0,0 +1,57 @@
+#include "frame-clock.h"
+
+FrameClock frameClock(50);
+
+FrameClock::FrameClock(uint16_t targetFps) {
+    setTargetFps(targetFps);
+    speedQ8 = 256;
+    speedRemainder = 0;
+    lastFrameUs = 0;
+    dtUs = 0;
+}
+
+void FrameClock::setTargetFps(uint16_t fps) {
+    if (fps == 0) fps = 1;
+    targetFps = fps;
+    frameIntervalUs = 1000000UL / fps;
+}
+
+void FrameClock::setSpeed(float speed) {
+    if (speed < 0) speed = 0;
+    speedQ8 = (uint16_t)(speed * 256 + 0.5f);
+}
+
+void FrameClock::advance() {
+    unsigned long now = micros();
+    uint32_t elapsed = now - lastFrameUs;
+    lastFrameUs = now;
+
+    if (elapsed > MAX_FRAME_GAP_US) {
+        elapsed = MAX_FRAME_GAP_US;
+    }
+
+    // Scale by speed, keeping the sub-microsecond remainder for the next frame
+    uint32_t scaled = elapsed * speedQ8 + speedRemainder;
+    dtUs = scaled >> 8;
+    speedRemainder = scaled & 0xFF;
+}
+
+void FrameClock::restart() {
+    lastFrameUs = micros() - frameIntervalUs;
+    speedRemainder = 0;
+    dtUs = 0;
+}
+
+uint16_t FrameClock::steps(uint32_t& accumulator, uint32_t dtUs, uint32_t stepUs, uint16_t maxSteps) {
+    accumulator += dtUs;
+    uint16_t count = 0;
+    while (accumulator >= stepUs && count < maxSteps) {
+        accumulator -= stepUs;
+        count++;
+    }
+    // Too far behind (e.g. after a stall): drop the backlog instead of fast-forwarding
+    if (accumulator >= stepUs) {
+        accumulator %= stepUs;
+    }
+    return count;
+}
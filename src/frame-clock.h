@@ -0,0 +1,46 @@
+// frame-clock.h - Central fixed-rate frame clock handing animations a speed-scaled dt
+#pragma once
+
+#include <Arduino.h>
+
+// Holds the target frame rate the render task is paced at and measures how much
+// animation time has passed since the last frame. Animation time is wall time
+// multiplied by the speed setting in 8.8 fixed point; the fractional remainder is
+// carried between frames so nothing drifts at any speed. The render task hands dt
+// to the effect's update(); effects advance by it instead of counting ticks.
+class FrameClock {
+public:
+    FrameClock(uint16_t targetFps);
+
+    void setTargetFps(uint16_t fps);
+    uint16_t getTargetFps() const { return targetFps; }
+    uint32_t getFrameIntervalUs() const { return frameIntervalUs; }
+
+    // Speed multiplier, e.g. 0.2 .. 3.0
+    void setSpeed(float speed);
+
+    // Start a new frame now; dt() then holds the elapsed animation time
+    void advance();
+    // Forget the time since the last frame, e.g. after switching animations
+    void restart();
+
+    // Animation time since the previous frame, in microseconds (speed applied)
+    uint32_t dt() const { return dtUs; }
+
+    // Fixed-step helper for effects that evolve in discrete steps: adds the dtUs the
+    // effect was updated with to its accumulator and returns how many whole steps of
+    // stepUs have elapsed
+    static uint16_t steps(uint32_t& accumulator, uint32_t dtUs, uint32_t stepUs, uint16_t maxSteps = 4);
+
+private:
+    static const uint32_t MAX_FRAME_GAP_US = 250000;  // clamp after long blocking calls
+
+    uint16_t targetFps;
+    uint32_t frameIntervalUs;
+    uint16_t speedQ8;
+    uint32_t speedRemainder;
+    unsigned long lastFrameUs;
+    uint32_t dtUs;
+};
+
+extern FrameClock frameClock;
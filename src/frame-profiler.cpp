@@ -0,0 +1,35 @@
+#include "frame-profiler.h"
+
+FrameProfiler frameProfiler;
+
+FrameProfiler::FrameProfiler() {
+    frameStart = 0;
+    outputStart = 0;
+    reset();
+}
+
+void FrameProfiler::record(FrameStats& stats, uint32_t cycles) {
+    stats.frames++;
+    stats.lastCycles = cycles;
+    stats.totalCycles += cycles;
+    if (cycles > stats.maxCycles) {
+        stats.maxCycles = cycles;
+    }
+}
+
+void FrameProfiler::endFrame(AnimationMode mode) {
+    // Cycle counter wraps every ~53 s at 80 MHz; unsigned subtraction handles it
+    uint32_t cycles = ESP.getCycleCount() - frameStart;
+    if (mode < ANIMATION_MODE_COUNT) {
+        record(renderStats[mode], cycles);
+    }
+}
+
+void FrameProfiler::endOutput() {
+    record(outputStats, ESP.getCycleCount() - outputStart);
+}
+
+void FrameProfiler::reset() {
+    memset(renderStats, 0, sizeof(renderStats));
+    memset(&outputStats, 0, sizeof(outputStats));
+}
@@ -0,0 +1,44 @@
+// frame-profiler.h - CPU cycle counters for animation frames and LED output
+#pragma once
+
+#include <Arduino.h>
+#include "webserver.h"
+
+struct FrameStats {
+    uint32_t frames;
+    uint32_t lastCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+
+    uint32_t averageCycles() const { return frames ? (uint32_t)(totalCycles / frames) : 0; }
+};
+
+// Measures render time per animation (cycles spent building a frame, excluding the
+// strip transfer) and the cost of the output stage separately, so kernel changes can
+// be compared with repeatable numbers from /getStats instead of by eye.
+class FrameProfiler {
+public:
+    FrameProfiler();
+
+    void startFrame() { frameStart = ESP.getCycleCount(); }
+    void endFrame(AnimationMode mode);
+
+    void startOutput() { outputStart = ESP.getCycleCount(); }
+    void endOutput();
+
+    const FrameStats& getStats(AnimationMode mode) const { return renderStats[mode]; }
+    const FrameStats& getOutputStats() const { return outputStats; }
+    void reset();
+
+    static uint32_t cyclesToMicros(uint32_t cycles) { return cycles / ESP.getCpuFreqMHz(); }
+
+private:
+    FrameStats renderStats[ANIMATION_MODE_COUNT];
+    FrameStats outputStats;
+    uint32_t frameStart;
+    uint32_t outputStart;
+
+    static void record(FrameStats& stats, uint32_t cycles);
+};
+
+extern FrameProfiler frameProfiler;
@@ -0,0 +1,88 @@
+#include "framebuffer.h"
+#include "frame-profiler.h"
+#include "power-limiter.h"
+#include "overlay.h"
+
+FrameBuffer::FrameBuffer(LedOutput& output, uint16_t numPixels)
+    : Canvas(numPixels), output(output) {
+    front = new Rgb16[pixelCount];
+    out = new uint32_t[pixelCount];
+    residual = new uint8_t[pixelCount * 3];
+    memset(front, 0, pixelCount * sizeof(Rgb16));
+    memset(residual, 0, pixelCount * 3);
+    forceShow = true;  // first frame always goes out
+    needsRefresh = false;
+    refreshIntervalUs = 0;
+    lastTransmitUs = 0;
+    framesShown = 0;
+    framesSkipped = 0;
+    framesRefreshed = 0;
+}
+
+FrameBuffer::~FrameBuffer() {
+    delete[] front;
+    delete[] out;
+    delete[] residual;
+}
+
+bool FrameBuffer::show() {
+    // Nothing drawn since the last show()
+    if (!forceShow && !dirty) {
+        return false;
+    }
+    // The finished frame matches what was sent
+    if (!forceShow && memcmp(pixels, front, pixelCount * sizeof(Rgb16)) == 0) {
+        dirty = false;
+        framesSkipped++;
+        return false;
+    }
+
+    // Previous frame still on the wire: keep this one pending
+    if (output.busy()) {
+        return false;
+    }
+
+    memcpy(front, pixels, pixelCount * sizeof(Rgb16));
+    dirty = false;
+    forceShow = false;
+    if (!transmit()) {
+        forceShow = true;
+        return false;
+    }
+    framesShown++;
+    return true;
+}
+
+bool FrameBuffer::refresh() {
+    if (dirty || forceShow) {
+        return false;
+    }
+    bool ditherDue = needsRefresh && refreshIntervalUs != 0 &&
+                     micros() - lastTransmitUs >= refreshIntervalUs;
+    if (!ditherDue && !overlay.changed()) {
+        return false;
+    }
+    if (output.busy()) {
+        return false;
+    }
+    if (!transmit()) {
+        return false;
+    }
+    framesRefreshed++;
+    return true;
+}
+
+bool FrameBuffer::update() {
+    return show() || refresh();
+}
+
+bool FrameBuffer::transmit() {
+    frameProfiler.startOutput();
+    needsRefresh = colorPipeline.process(front, out, residual, pixelCount);
+    overlay.compose(out, pixelCount);
+    powerLimiter.apply(out, pixelCount);
+    bool sent = output.show(out, pixelCount);
+    frameProfiler.endOutput();
+    lastTransmitUs = micros();
+    return sent;
+}
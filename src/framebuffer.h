@@ -0,0 +1,54 @@
+// framebuffer.h - Double-buffered canvas in front of the LED output backend
+#pragma once
+
+#include <Arduino.h>
+#include "led-output.h"
+#include "canvas.h"
+
+// Animations draw into the canvas (the back buffer); show() compares the finished
+// frame with the front buffer (the last frame accepted for output) and only
+// transmits when they differ.
+// A frame the output is still too busy to take stays pending until the next show().
+// On the way out every frame goes through the colour pipeline (brightness, white
+// balance, dithering to 8 bits) into the output buffer, and the power limiter scales that if needed.
+// refresh() re-sends the current frame so temporal dithering can work between
+// animation updates, and so status overlay sprites can blink over a still frame.
+class FrameBuffer : public Canvas {
+public:
+    FrameBuffer(LedOutput& output, uint16_t numPixels);
+    ~FrameBuffer();
+
+    // Send the back buffer to the strip if it changed; returns true if a frame was sent
+    bool show();
+    // Force the next show() to transmit, e.g. after something wrote to the strip directly
+    void invalidate() { forceShow = true; }
+
+    // Re-send the current frame with fresh dither if it needs it and refreshIntervalUs
+    // has passed (0 disables that), or when the overlay changed; returns true if a
+    // frame was sent.
+    bool refresh();
+    // show(), or refresh() if there was no new frame to send
+    bool update();
+    void setRefreshInterval(uint32_t us) { refreshIntervalUs = us; }
+
+    unsigned long getFramesShown() const { return framesShown; }
+    unsigned long getFramesSkipped() const { return framesSkipped; }
+    unsigned long getFramesRefreshed() const { return framesRefreshed; }
+
+private:
+    LedOutput& output;
+    Rgb16* front;
+    uint32_t* out;       // front after the colour pipeline, as sent
+    uint8_t* residual;   // dither error carried per pixel and channel
+    bool forceShow;
+    bool needsRefresh;
+    uint32_t refreshIntervalUs;
+    unsigned long lastTransmitUs;
+    unsigned long framesShown;
+    unsigned long framesSkipped;
+    unsigned long framesRefreshed;
+
+    bool transmit();
+};
+
+extern FrameBuffer frameBuffer;
@@ -0,0 +1,77 @@
+#include "golden-frames.h"
+#include "prng.h"
+#include "matrix-geometry.h"
+
+// Effects whose frames depend only on the seed and dt. Temperature follows the
+// sensor, Auto Cycle wall time, Color Picker and Draw Mode the web interface.
+const AnimationMode GoldenReplay::SUITE[SUITE_LENGTH] = {
+    ANIMATION_QIX_LINES, ANIMATION_STARFIELD, ANIMATION_STAR_WARP, ANIMATION_NEBULA,
+    ANIMATION_RED, ANIMATION_MATRIX, ANIMATION_FIRE
+};
+
+uint32_t GoldenReplay::hashFrame(const Canvas& canvas) {
+    uint32_t hash = 2166136261u;
+    const Rgb16* pixels = canvas.getPixels();
+    for (uint16_t i = 0; i < canvas.numPixels(); i++) {
+        const uint16_t channels[3] = { pixels[i].r, pixels[i].g, pixels[i].b };
+        for (uint16_t value : channels) {
+            hash = (hash ^ (value & 0xFF)) * 16777619u;
+            hash = (hash ^ (value >> 8)) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+void GoldenReplay::start() {
+    abort();
+    canvas = new Canvas(DisplayGeometry::PIXELS);
+    nextEntry = 0;
+    nextFrame = 0;
+}
+
+bool GoldenReplay::step() {
+    if (!canvas) {
+        return false;
+    }
+    if (nextEntry == SUITE_LENGTH) {
+        abort();
+        return false;
+    }
+
+    entry = nextEntry;
+    frame = nextFrame;
+    Animation* animation = getAnimation();
+    if (frame == 0) {
+        // Every effect starts from the same seed sequence, whatever ran before it
+        uint32_t savedSeed = Prng::getBaseSeed();
+        Prng::setBaseSeed(SEED);
+        canvas->clear();
+        animation->begin();
+        Prng::setBaseSeed(savedSeed);
+    }
+
+    uint32_t start = ESP.getCycleCount();
+    animation->update(FRAME_DT_US);
+    animation->render(*canvas);
+    cycles = ESP.getCycleCount() - start;
+    hash = hashFrame(*canvas);
+
+    if (++nextFrame == FRAMES) {
+        animation->end();
+        nextEntry++;
+        nextFrame = 0;
+    }
+    return true;
+}
+
+void GoldenReplay::abort() {
+    if (!canvas) {
+        return;
+    }
+    // An effect is mid-replay unless the next frame starts a new one
+    if (nextFrame != 0) {
+        getAnimation()->end();
+    }
+    delete canvas;
+    canvas = nullptr;
+}
@@ -0,0 +1,53 @@
+// golden-frames.h - Deterministic frame-by-frame replay of the effects for golden checks
+#pragma once
+
+#include <Arduino.h>
+#include "animation.h"
+
+// Replays every deterministic effect from a fixed seed on a simulated 50 fps clock
+// into an off-screen canvas and hashes each frame. Comparing the hashes with stored
+// goldens shows whether a kernel change is bit-exact; a deliberate change of look is
+// re-baselined by storing new goldens. One step() renders one frame, so callers can
+// spread a run over as many slices as they like. Hashes are of the linear canvas,
+// so they depend on the build's colour settings (LED_GAMMA) and the palettes.
+class GoldenReplay {
+public:
+    static const uint16_t FRAMES = 100;
+    static const uint32_t FRAME_DT_US = 20000;
+    static const uint32_t SEED = 0x5EED1234;
+    static const uint8_t SUITE_LENGTH = 7;
+    static const AnimationMode SUITE[SUITE_LENGTH];
+
+    // FNV-1a over every channel of every pixel
+    static uint32_t hashFrame(const Canvas& canvas);
+
+    GoldenReplay() : canvas(nullptr), entry(0), frame(0), hash(0), cycles(0) {}
+    ~GoldenReplay() { abort(); }
+
+    // Rewind to the first frame of the suite. The effects are shared with the
+    // player, so nothing else may run them until the replay is finished.
+    void start();
+    // Render the next frame; false once the whole suite has been replayed
+    bool step();
+    // End the replay early, releasing the effect and canvas it holds
+    void abort();
+    bool isRunning() const { return canvas != nullptr; }
+
+    // The frame the last step() rendered: suite entry, frame within it, its hash and
+    // CPU cycles spent in update and render
+    uint8_t getEntry() const { return entry; }
+    uint16_t getFrame() const { return frame; }
+    uint32_t getHash() const { return hash; }
+    uint32_t getCycles() const { return cycles; }
+    Animation* getAnimation() const { return AnimationRegistry::get(SUITE[entry]); }
+    bool isLastFrame() const { return frame == FRAMES - 1; }
+
+private:
+    Canvas* canvas;
+    uint8_t entry;
+    uint16_t frame;
+    uint32_t hash;
+    uint32_t cycles;
+    uint8_t nextEntry;
+    uint16_t nextFrame;
+};
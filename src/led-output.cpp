@@ -0,0 +1,119 @@
+#include "led-output.h"
+#include <ets_sys.h>
+
+void BitBangLedOutput::begin() {
+    strip.begin();
+}
+
+bool BitBangLedOutput::show(const uint32_t* pixels, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        strip.setPixelColor(i, pixels[i]);
+    }
+
+    // Disable interrupts briefly for clean NeoPixel update
+    noInterrupts();
+    strip.show();
+    interrupts();
+    return true;
+}
+
+UartLedOutput::UartLedOutput(uint16_t numPixels, Ws2812Order order) : order(order) {
+    capacity = (uint32_t)numPixels * 3 * WS2812_UART_BYTES_PER_CHANNEL;
+    encoded = new uint8_t[capacity];
+    sendPosition = 0;
+    sendLength = 0;
+    latching = false;
+    latchStart = 0;
+}
+
+UartLedOutput::~UartLedOutput() {
+    delete[] encoded;
+}
+
+void UartLedOutput::begin() {
+    Serial1.begin(WS2812_UART_BAUD, SERIAL_6N1, SERIAL_TX_ONLY);
+
+    // Invert TX so the idle line is low and start bits become the leading high slot
+    USC0(UART1) |= (1 << UCTXI);
+    // Refill when the FIFO drops below 32 bytes (80 us of data left at 3.2 Mbaud)
+    USC1(UART1) = (32 << UCFET);
+
+    ETS_UART_INTR_DISABLE();
+    USIE(UART1) = 0;
+    USIC(UART1) = 0xffff;
+    // Serial's receive handler shares this vector and is replaced below
+    USIE(UART0) = 0;
+    USIC(UART0) = 0xffff;
+    ETS_UART_INTR_ATTACH(uartInterrupt, this);
+    ETS_UART_INTR_ENABLE();
+
+    Serial.println("UART LED output started on GPIO2");
+}
+
+void IRAM_ATTR UartLedOutput::fillFifo() {
+    uint32_t position = sendPosition;
+    uint32_t length = sendLength;
+    while (position < length && ((USS(UART1) >> USTXC) & 0xff) < 128) {
+        USF(UART1) = encoded[position++];
+    }
+    sendPosition = position;
+}
+
+void IRAM_ATTR UartLedOutput::uartInterrupt(void* arg) {
+    UartLedOutput* self = (UartLedOutput*)arg;
+
+    if (USIS(UART1) & (1 << UIFE)) {
+        self->fillFifo();
+        if (self->sendPosition >= self->sendLength) {
+            USIE(UART1) &= ~(1 << UIFE);
+        }
+    }
+
+    // Acknowledge everything on both UARTs; UART0 has no receive handler while we own the vector
+    USIC(UART1) = 0xffff;
+    USIC(UART0) = 0xffff;
+}
+
+bool UartLedOutput::busy() {
+    if (sendLength == 0) {
+        return false;
+    }
+    if (sendPosition < sendLength || ((USS(UART1) >> USTXC) & 0xff) > 0) {
+        return true;
+    }
+
+    // Last byte has left the FIFO; hold the line low long enough for the strip to latch
+    if (!latching) {
+        latching = true;
+        latchStart = micros();
+    }
+    if (micros() - latchStart < LATCH_US) {
+        return true;
+    }
+
+    latching = false;
+    sendLength = 0;
+    sendPosition = 0;
+    return false;
+}
+
+bool UartLedOutput::show(const uint32_t* pixels, uint16_t count) {
+    if (busy()) {
+        return false;
+    }
+
+    uint16_t maxPixels = capacity / (3 * WS2812_UART_BYTES_PER_CHANNEL);
+    if (count > maxPixels) {
+        count = maxPixels;
+    }
+    uint32_t length = ws2812EncodeUart(pixels, count, order, encoded);
+
+    ETS_UART_INTR_DISABLE();
+    sendPosition = 0;
+    sendLength = length;
+    fillFifo();
+    USIC(UART1) = (1 << UIFE);
+    USIE(UART1) |= (1 << UIFE);
+    ETS_UART_INTR_ENABLE();
+    return true;
+}
@@ -0,0 +1,60 @@
+// led-output.h - Output backends that transmit finished frames to the LED strip
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include "ws2812-encoder.h"
+
+// FrameBuffer hands every changed frame to one of these. Pixels are 0x00RRGGBB.
+class LedOutput {
+public:
+    virtual ~LedOutput() {}
+
+    virtual void begin() = 0;
+    // True while the previous frame is still on the wire (or in its latch time)
+    virtual bool busy() = 0;
+    // Start sending a frame; returns false and drops nothing if the output is busy
+    virtual bool show(const uint32_t* pixels, uint16_t count) = 0;
+};
+
+// Adafruit_NeoPixel bit-bang on any GPIO. Blocks for the whole frame (~6.7 ms for
+// 224 LEDs) with interrupts disabled.
+class BitBangLedOutput : public LedOutput {
+public:
+    BitBangLedOutput(Adafruit_NeoPixel& strip) : strip(strip) {}
+
+    void begin() override;
+    bool busy() override { return !strip.canShow(); }
+    bool show(const uint32_t* pixels, uint16_t count) override;
+
+private:
+    Adafruit_NeoPixel& strip;
+};
+
+// Hardware UART1 driving the strip from GPIO2 (D4). The frame is encoded into a
+// buffer and fed to the TX FIFO from the FIFO-empty interrupt, so show() returns
+// immediately and interrupts stay enabled while the frame goes out.
+// Takes over the shared UART interrupt: Serial stays usable for output only.
+class UartLedOutput : public LedOutput {
+public:
+    UartLedOutput(uint16_t numPixels, Ws2812Order order);
+    ~UartLedOutput();
+
+    void begin() override;
+    bool busy() override;
+    bool show(const uint32_t* pixels, uint16_t count) override;
+
+private:
+    static const uint32_t LATCH_US = 300;  // newer WS2812B revisions need > 280 us low
+
+    Ws2812Order order;
+    uint8_t* encoded;
+    uint32_t capacity;
+    volatile uint32_t sendPosition;
+    volatile uint32_t sendLength;
+    bool latching;
+    unsigned long latchStart;
+
+    void fillFifo();
+    static void uartInterrupt(void* arg);
+};
@@ -0,0 +1,61 @@
+#include "line.h"
+#include "matrix-geometry.h"
+
+// Add one anti-aliased pixel of a line; coverage 0..255
+static inline void plotLinePixel(Canvas& canvas, int col, int row, const Rgb16& color, BlendMode mode, uint16_t coverage) {
+    if (coverage && DisplayGeometry::inBounds(col, row)) {
+        canvas.blendPixel(DisplayGeometry::table.index[row * MATRIX_COLS + col], color, mode, coverage > 255 ? 255 : coverage);
+    }
+}
+
+void drawLine(Canvas& canvas, float x1, float y1, float x2, float y2, uint32_t color, BlendMode mode) {
+    int32_t ax = (int32_t)(x1 * 256);
+    int32_t ay = (int32_t)(y1 * 256);
+    int32_t bx = (int32_t)(x2 * 256);
+    int32_t by = (int32_t)(y2 * 256);
+    Rgb16 linear = colorPipeline.toLinear(color);
+
+    // Walk along the major axis, left to right
+    bool steep = abs(by - ay) > abs(bx - ax);
+    if (steep) {
+        int32_t t;
+        t = ax; ax = ay; ay = t;
+        t = bx; bx = by; by = t;
+    }
+    if (ax > bx) {
+        int32_t t;
+        t = ax; ax = bx; bx = t;
+        t = ay; ay = by; by = t;
+    }
+
+    int32_t dx = bx - ax;
+    int32_t gradient = dx ? (by - ay) * 65536 / dx : 0;  // 16.16, one division per line
+    int32_t first = (ax + 128) >> 8;
+    int32_t last = (bx + 128) >> 8;
+
+    // Minor coordinate at the first column, 16.16, then one add per column. Values
+    // may be negative near the top or left edge: they are scaled up by multiplying
+    // and only ever shifted right, which floors them
+    int32_t minor = ay * 256 + ((first * 256 - ax) * gradient >> 8);
+    for (int32_t major = first; major <= last; major++, minor += gradient) {
+        int32_t cell = minor >> 16;
+        uint16_t below = (minor >> 8) & 0xFF;
+
+        // End columns only partly covered by the line
+        uint16_t coverage = 256;
+        if (first != last) {
+            if (major == first) coverage = 256 - ((ax + 128) & 0xFF);
+            else if (major == last) coverage = ((bx + 128) & 0xFF) + 1;
+        }
+
+        uint16_t near = ((256 - below) * coverage) >> 8;
+        uint16_t far = (below * coverage) >> 8;
+        if (steep) {
+            plotLinePixel(canvas, cell, major, linear, mode, near);
+            plotLinePixel(canvas, cell + 1, major, linear, mode, far);
+        } else {
+            plotLinePixel(canvas, major, cell, linear, mode, near);
+            plotLinePixel(canvas, major, cell + 1, linear, mode, far);
+        }
+    }
+}
@@ -0,0 +1,13 @@
+// line.h - Anti-aliased line rasteriser for the canvas
+#pragma once
+
+#include <Arduino.h>
+#include "canvas.h"
+
+// Xiaolin Wu's anti-aliased line in 24.8 fixed point. The endpoints keep their
+// sub-pixel position, so a slowly moving line fades from one row to the next instead
+// of snapping; each column (or row, for steep lines) lights the two pixels the line
+// passes between, weighted by distance. Pixel centres are at integer coordinates and
+// the line is clipped to the matrix. Coverage is passed to the blend as alpha, so use
+// BLEND_ALPHA or BLEND_ADD.
+void drawLine(Canvas& canvas, float x1, float y1, float x2, float y2, uint32_t color, BlendMode mode = BLEND_ALPHA);
@@ -22,12 +22,22 @@
 #include "ota-handler.h"
 #include "wifi.h"
 #include "webserver.h"
+#include "stream-receiver.h"
+#include "led-output.h"
+#include "framebuffer.h"
+#include "matrix-geometry.h"
+#include "frame-profiler.h"
+#include "frame-clock.h"
+#include "scheduler.h"
+#include "animation.h"
+#include "prng.h"
+#include "self-test.h"
 
 int buttonState = HIGH;
 int lastButtonState = HIGH;
 int ledState = LOW;
 int ledStripPin = 13;
-int ledStripNumpixels = 224;
+int ledStripNumpixels = MATRIX_PIXELS;
 int lightState = LIGHT_OFF; // 0 - off, 1 - turning on, 2 - on, 3 - turning off
 
 int selectedPixelNumber = 0;
@@ -42,6 +52,14 @@ unsigned long lastPir1Time = 0;
 unsigned long lastMakeLight = 0;
 
 Adafruit_NeoPixel myLedStrip(ledStripNumpixels, ledStripPin, NEO_BGR + NEO_KHZ800);
+// LED output backend: bit-bang on ledStripPin by default, or build with
+// -DLED_OUTPUT_UART to drive the strip from UART1 on GPIO2 (D4) without blocking
+#ifdef LED_OUTPUT_UART
+UartLedOutput ledOutput(ledStripNumpixels, WS2812_ORDER_BGR);
+#else
+BitBangLedOutput ledOutput(myLedStrip);
+#endif
+FrameBuffer frameBuffer(ledOutput, ledStripNumpixels);
 
 // Temperature sensor
 Adafruit_AHTX0 aht;
@@ -52,12 +70,12 @@ float animationSpeed = 1.0;
 
 // Color picker and drawing variables
 uint32_t selectedColor = 0x00FF00;  // Default to green
-uint32_t drawingGrid[32][7];  // 32x7 matrix for pixel colors (0 = off, >0 = color)
-bool needsGridUpdate = true;  // Flag to update grid display
+uint32_t drawingGrid[MATRIX_COLS][MATRIX_ROWS];  // 32x7 matrix for pixel colors (0 = off, >0 = color)
 
 // Global temperature variable for web interface
 float currentTemperature = -999.0;
 float currentHumidity = -999.0;
+bool temperatureValid = false;  // Last sensor read succeeded
 
 // Watchdog timer variables
 Ticker secondTick;
@@ -67,19 +85,19 @@ unsigned long lastWatchdogFeed = 0;
 
 // Function declarations
 void feedWatchdog();
-void animateQixLines(unsigned long durationMs);
-void drawLine(float x1, float y1, float x2, float y2, uint32_t color);
-void animateStarfield(unsigned long durationMs);
-void animateStarWarp(unsigned long durationMs);
-void animateNebula(unsigned long durationMs);
-void animateAllRed(unsigned long durationMs);
-void animateColorPicker(unsigned long durationMs);
-void animateDrawMode(unsigned long durationMs);
-void animateTemperature(unsigned long durationMs);
-void displayTemperatureDigits(float temperature);
-void displayTemperatureError();
 void clearDrawingGrid();
 void setDrawingPixel(int col, int row, bool state);
+void renderTask();
+void outputTask();
+void httpTask();
+void streamTask();
+void otaTask();
+void wifiTask();
+void sensorTask();
+void watchdogTask();
+
+// Scheduler slot of the render task, to follow the effect's frame rate
+int renderTaskId = -1;
 
 uint8_t activePixel = 0;
 bool squareEffectDone = false;
@@ -87,756 +105,79 @@ bool racingEffectDone = false;
 bool matrixEffectDone = false;
 bool everyTenthDone = false;
 
-// map column,row -> pixel index for a 32x7 matrix laid out in a serpentine (zig-zag) strip
-int pixelIndex(int col, int row)
-{
-	const int cols = 32;
-	// bounds safety
-	if (col < 0) col = 0;
-	if (col >= cols) col = cols - 1;
-	if (row < 0) row = 0;
-	if (row >= 7) row = 6;
-
-	int base = row * cols;
-	if ((row & 1) == 0)
-	{
-		// even rows go left->right
-		return base + col;
-	}
-	else
-	{
-		// odd rows go right->left (serpentine)
-		return base + (cols - 1 - col);
-	}
-}
-
-// Helper function to draw a line using Bresenham's algorithm
-void drawLine(float x1, float y1, float x2, float y2, uint32_t color)
+// Clear the drawing grid
+void clearDrawingGrid()
 {
-	int ix1 = (int)x1;
-	int iy1 = (int)y1;
-	int ix2 = (int)x2;
-	int iy2 = (int)y2;
-	
-	int dx = abs(ix2 - ix1);
-	int dy = abs(iy2 - iy1);
-	int sx = (ix1 < ix2) ? 1 : -1;
-	int sy = (iy1 < iy2) ? 1 : -1;
-	int err = dx - dy;
-	
-	int x = ix1;
-	int y = iy1;
-	
-	while (true) {
-		// Set pixel if within bounds
-		if (x >= 0 && x < 32 && y >= 0 && y < 7) {
-			int idx = pixelIndex(x, y);
-			myLedStrip.setPixelColor(idx, color);
-		}
-		
-		if (x == ix2 && y == iy2) break;
-		
-		int e2 = 2 * err;
-		if (e2 > -dy) {
-			err -= dy;
-			x += sx;
-		}
-		if (e2 < dx) {
-			err += dx;
-			y += sy;
+	for (int col = 0; col < MATRIX_COLS; col++) {
+		for (int row = 0; row < MATRIX_ROWS; row++) {
+			drawingGrid[col][row] = 0;  // 0 = off
 		}
 	}
 }
 
-// Qix-style moving lines animation
-void animateQixLines(unsigned long durationMs)
-{
-	static float line1X1 = 16.0, line1Y1 = 3.5;
-	static float line1X2 = 24.0, line1Y2 = 2.0;
-	static float line1DX1 = 0.3, line1DY1 = 0.2;
-	static float line1DX2 = -0.4, line1DY2 = 0.3;
-	
-	static float line2X1 = 8.0, line2Y1 = 1.0;
-	static float line2X2 = 12.0, line2Y2 = 5.5;
-	static float line2DX1 = 0.5, line2DY1 = 0.1;
-	static float line2DX2 = -0.2, line2DY2 = -0.4;
-	
-	static unsigned long lastUpdate = 0;
-	
-	// Update animation every 50ms (adjusted by speed)
-	unsigned long updateInterval = (unsigned long)(50 / animationSpeed);
-	if (millis() - lastUpdate >= updateInterval) {
-		lastUpdate = millis();
-		
-		const int cols = 32;
-		const int rows = 7;
-		
-		// Clear display
-		myLedStrip.clear();
-		
-		// Update line 1 positions
-		line1X1 += line1DX1;
-		line1Y1 += line1DY1;
-		line1X2 += line1DX2;
-		line1Y2 += line1DY2;
-		
-		// Update line 2 positions
-		line2X1 += line2DX1;
-		line2Y1 += line2DY1;
-		line2X2 += line2DX2;
-		line2Y2 += line2DY2;
-		
-		// Bounce line 1 endpoints off boundaries
-		if (line1X1 <= 0 || line1X1 >= cols-1) line1DX1 = -line1DX1;
-		if (line1Y1 <= 0 || line1Y1 >= rows-1) line1DY1 = -line1DY1;
-		if (line1X2 <= 0 || line1X2 >= cols-1) line1DX2 = -line1DX2;
-		if (line1Y2 <= 0 || line1Y2 >= rows-1) line1DY2 = -line1DY2;
-		
-		// Bounce line 2 endpoints off boundaries
-		if (line2X1 <= 0 || line2X1 >= cols-1) line2DX1 = -line2DX1;
-		if (line2Y1 <= 0 || line2Y1 >= rows-1) line2DY1 = -line2DY1;
-		if (line2X2 <= 0 || line2X2 >= cols-1) line2DX2 = -line2DX2;
-		if (line2Y2 <= 0 || line2Y2 >= rows-1) line2DY2 = -line2DY2;
-		
-		// Draw line 1 (cyan)
-		drawLine(line1X1, line1Y1, line1X2, line1Y2, myLedStrip.Color(0, 100, 100));
-		
-		// Draw line 2 (magenta)
-		drawLine(line2X1, line2Y1, line2X2, line2Y2, myLedStrip.Color(100, 0, 100));
-		
-		// Disable interrupts briefly for clean NeoPixel update
-		noInterrupts();
-		myLedStrip.show();
-		interrupts();
-	}
-	
-	// Handle periodic tasks less frequently for better web performance
-	if (millis() - lastUpdate >= 500) {
-		handleOTA();
-		handleWebServer();
-		feedWatchdog();
-	}
-	
-	// Check for animation change for better responsiveness
-	if (animationChanged) {
-		return; // Exit immediately if animation changed
-	}
-}
-
-// Starfield animation - stars moving from left to right at different speeds
-void animateStarfield(unsigned long durationMs)
+// Set or clear a pixel in the drawing grid
+void setDrawingPixel(int col, int row, bool state)
 {
-	static struct Star {
-		float x, y;
-		float speed;
-		uint8_t brightness;
-		bool active;
-	} stars[16];
-	
-	static bool initialized = false;
-	static unsigned long lastUpdate = 0;
-	
-	// Initialize stars
-	if (!initialized) {
-		for (int i = 0; i < 16; i++) {
-			stars[i].active = false;
-		}
-		initialized = true;
-		lastUpdate = millis();
-	}
-	
-	// Update animation every 80ms (adjusted by speed)
-	unsigned long updateInterval = (unsigned long)(80 / animationSpeed);
-	if (millis() - lastUpdate >= updateInterval) {
-		lastUpdate = millis();
-		
-		const int cols = 32;
-		const int rows = 7;
-		
-		// Clear display
-		myLedStrip.clear();
-		
-		// Create new stars randomly
-		if (random(0, 100) < 30) {
-			for (int i = 0; i < 16; i++) {
-				if (!stars[i].active) {
-					stars[i].x = -1.0;
-					stars[i].y = random(0, rows);
-					stars[i].speed = (0.2 + (random(0, 100) / 100.0) * 0.8) * animationSpeed; // Speed between 0.2 and 1.0, adjusted by speed
-					stars[i].brightness = 50 + random(0, 150); // Brightness between 50 and 200
-					stars[i].active = true;
-					break;
-				}
-			}
-		}
-		
-		// Update and draw stars
-		for (int i = 0; i < 16; i++) {
-			if (stars[i].active) {
-				// Move star
-				stars[i].x += stars[i].speed;
-				
-				// Check if star is still visible
-				if (stars[i].x >= cols) {
-					stars[i].active = false;
-					continue;
-				}
-				
-				// Draw star if within bounds
-				if (stars[i].x >= 0 && stars[i].x < cols && stars[i].y >= 0 && stars[i].y < rows) {
-					int ix = (int)stars[i].x;
-					int iy = (int)stars[i].y;
-					int idx = pixelIndex(ix, iy);
-					
-					// Create white star with varying brightness
-					uint8_t b = stars[i].brightness;
-					myLedStrip.setPixelColor(idx, myLedStrip.Color(b, b, b));
-				}
-			}
-		}
-		
-		// Disable interrupts briefly for clean NeoPixel update
-		noInterrupts();
-		myLedStrip.show();
-		interrupts();
-	}
-	
-	// Handle periodic tasks less frequently for better web performance
-	if (millis() - lastUpdate >= 500) {
-		handleOTA();
-		handleWebServer();
-		feedWatchdog();
-	}
-	
-	// Check for animation change for better responsiveness
-	if (animationChanged) {
-		return; // Exit immediately if animation changed
+	if (DisplayGeometry::inBounds(col, row)) {
+		drawingGrid[col][row] = state ? selectedColor : 0;  // Store color or 0 for off
 	}
 }
 
-// Star Warp animation - first person perspective traveling through stars
-void animateStarWarp(unsigned long durationMs)
+// Write a binary frame into the drawing grid. Pixels are numbered row by row
+// (row * MATRIX_COLS + col), colours are 3 bytes R, G, B and black is off.
+//   FRAME_FULL: the type byte, then every pixel's colour
+//   FRAME_RUNS: the type byte, then runs of start (2 bytes, little-endian),
+//               count (1 byte) and one colour for the count pixels from start
+// False if the body is malformed; the web server checks before queueing it.
+bool isValidDrawingFrame(const uint8_t* data, size_t length)
 {
-	static struct WarpStar {
-		float x, y; // Current position
-		float startX, startY; // Starting position near center
-		float dx, dy; // Direction vector
-		float speed;
-		uint8_t brightness;
-		bool active;
-		float life; // How far along the warp path (0.0 to 1.0)
-	} warpStars[24];
-	
-	static bool initialized = false;
-	static unsigned long lastUpdate = 0;
-	
-	// Initialize stars
-	if (!initialized) {
-		for (int i = 0; i < 24; i++) {
-			warpStars[i].active = false;
-		}
-		initialized = true;
-		lastUpdate = millis();
-	}
-	
-	// Update animation every 60ms (adjusted by speed)
-	unsigned long updateInterval = (unsigned long)(60 / animationSpeed);
-	if (millis() - lastUpdate >= updateInterval) {
-		lastUpdate = millis();
-		
-		const int cols = 32;
-		const int rows = 7;
-		const float centerX = cols / 2.0;
-		const float centerY = rows / 2.0;
-		
-		// Clear display
-		myLedStrip.clear();
-		
-		// Create new warp stars randomly
-		if (random(0, 100) < 40) {
-			for (int i = 0; i < 24; i++) {
-				if (!warpStars[i].active) {
-					// Start near center with slight random offset
-					warpStars[i].startX = centerX + random(-2, 3) * 0.5;
-					warpStars[i].startY = centerY + random(-1, 2) * 0.5;
-					warpStars[i].x = warpStars[i].startX;
-					warpStars[i].y = warpStars[i].startY;
-					
-					// Calculate direction vector from center outward
-					float dx = random(-100, 101) / 50.0; // -2.0 to 2.0
-					float dy = random(-100, 101) / 50.0; // -2.0 to 2.0
-					
-					// Favor horizontal movement due to rectangular display
-					if (abs(dx) < 0.3) dx = (dx < 0) ? -0.8 : 0.8;
-					
-					warpStars[i].dx = dx;
-					warpStars[i].dy = dy;
-					warpStars[i].speed = (0.05 + (random(0, 50) / 100.0) * 0.1) * animationSpeed; // 0.05 to 0.15, adjusted by speed
-					warpStars[i].brightness = 60 + random(0, 120); // 60 to 180
-					warpStars[i].life = 0.0;
-					warpStars[i].active = true;
-					break;
-				}
-			}
-		}
-		
-		// Update and draw warp stars
-		for (int i = 0; i < 24; i++) {
-			if (warpStars[i].active) {
-				// Update life progress
-				warpStars[i].life += warpStars[i].speed;
-				
-				// Check if star has reached end of life
-				if (warpStars[i].life >= 1.0) {
-					warpStars[i].active = false;
-					continue;
-				}
-				
-				// Calculate accelerating movement (starts slow, gets faster)
-				float accel = warpStars[i].life * warpStars[i].life; // Quadratic acceleration
-				warpStars[i].x = warpStars[i].startX + warpStars[i].dx * accel * 20;
-				warpStars[i].y = warpStars[i].startY + warpStars[i].dy * accel * 20;
-				
-				// Draw star trail effect
-				for (int trail = 0; trail < 3; trail++) {
-					float trailLife = warpStars[i].life - trail * 0.02;
-					if (trailLife <= 0) break;
-					
-					float trailAccel = trailLife * trailLife;
-					float trailX = warpStars[i].startX + warpStars[i].dx * trailAccel * 20;
-					float trailY = warpStars[i].startY + warpStars[i].dy * trailAccel * 20;
-					
-					// Check if trail point is within bounds
-					if (trailX >= 0 && trailX < cols && trailY >= 0 && trailY < rows) {
-						int ix = (int)trailX;
-						int iy = (int)trailY;
-						int idx = pixelIndex(ix, iy);
-						
-						// Create white star with fading trail
-						uint8_t brightness = warpStars[i].brightness * (1.0 - trail * 0.4) * (1.0 - warpStars[i].life * 0.2);
-						myLedStrip.setPixelColor(idx, myLedStrip.Color(brightness, brightness, brightness));
-					}
-				}
-			}
-		}
-		
-		// Disable interrupts briefly for clean NeoPixel update
-		noInterrupts();
-		myLedStrip.show();
-		interrupts();
+	if (length < 1) {
+		return false;
 	}
-	
-	// Handle periodic tasks less frequently for better web performance
-	if (millis() - lastUpdate >= 500) {
-		handleOTA();
-		handleWebServer();
-		feedWatchdog();
-	}
-	
-	// Check for animation change for better responsiveness
-	if (animationChanged) {
-		return; // Exit immediately if animation changed
-	}
-}
 
-// Nebula Swirl animation - rotating cosmic clouds with changing colors
-void animateNebula(unsigned long durationMs)
-{
-	static unsigned long lastUpdate = 0;
-	static float rotationAngle = 0.0;
-	static float colorPhase = 0.0;
-	
-	// Update animation every 80ms (adjusted by speed)
-	unsigned long updateInterval = (unsigned long)(80 / animationSpeed);
-	if (millis() - lastUpdate >= updateInterval) {
-		lastUpdate = millis();
-		
-		const int cols = 32;
-		const int rows = 7;
-		const float centerX = cols / 2.0;
-		const float centerY = rows / 2.0;
-		
-		// Update rotation and color phase
-		rotationAngle += 0.08 * animationSpeed; // Slow rotation adjusted by speed
-		colorPhase += 0.05 * animationSpeed;    // Color cycling speed adjusted
-		if (rotationAngle >= 2 * PI) rotationAngle -= 2 * PI;
-		if (colorPhase >= 2 * PI) colorPhase -= 2 * PI;
-		
-		// Clear display
-		myLedStrip.clear();
-		
-		// Draw nebula swirl
-		for (int x = 0; x < cols; x++) {
-			for (int y = 0; y < rows; y++) {
-				// Calculate distance and angle from center
-				float dx = x - centerX;
-				float dy = y - centerY;
-				float distance = sqrt(dx * dx + dy * dy);
-				float angle = atan2(dy, dx);
-				
-				// Create rotating spiral arms
-				float spiralAngle = angle + rotationAngle + distance * 0.3;
-				float spiralValue = sin(spiralAngle * 3) + sin(spiralAngle * 2);
-				
-				// Add radial waves
-				float radialWave = sin(distance * 0.8 + rotationAngle * 2);
-				
-				// Combine effects
-			float intensity = (spiralValue + radialWave + 2.0f) / 4.0f;
-			intensity = max(0.0f, min(1.0f, intensity));
-			
-			// Apply distance falloff
-			float maxDist = max(centerX, centerY);
-			float falloff = 1.0f - (distance / (maxDist * 1.5f));
-			falloff = max(0.0f, min(1.0f, falloff));
-				
-				if (intensity > 0.1) {
-					// Calculate color based on position and time
-					float colorAngle = angle + colorPhase + distance * 0.2;
-					
-					// Create rainbow colors
-					uint8_t r = (uint8_t)((sin(colorAngle) + 1) * 127 * intensity);
-					uint8_t g = (uint8_t)((sin(colorAngle + 2.094) + 1) * 127 * intensity); // +2π/3
-					uint8_t b = (uint8_t)((sin(colorAngle + 4.188) + 1) * 127 * intensity); // +4π/3
-					
-					// Apply some purple/pink bias for nebula feel
-					r = (r * 2 + b) / 3;
-					b = (b * 3 + r) / 4;
-					
-					int idx = pixelIndex(x, y);
-					myLedStrip.setPixelColor(idx, myLedStrip.Color(r, g, b));
-				}
-			}
-		}
-		
-		// Disable interrupts briefly for clean NeoPixel update
-		noInterrupts();
-		myLedStrip.show();
-		interrupts();
-	}
-	
-	// Handle periodic tasks less frequently for better web performance
-	if (millis() - lastUpdate >= 600) {
-		handleOTA();
-		handleWebServer();
-		feedWatchdog();
-	}
-	
-	// Check for animation change for better responsiveness
-	if (animationChanged) {
-		return; // Exit immediately if animation changed
+	if (data[0] == FRAME_FULL) {
+		return length == 1 + MATRIX_PIXELS * 3;
 	}
-}
-
-// All LEDs red at 10% brightness
-void animateAllRed(unsigned long durationMs)
-{
-	static bool isInitialized = false;
-	static unsigned long lastUpdate = 0;
-	
-	// Initialize the red display once
-	if (!isInitialized) {
-		Serial.println("Starting All Red animation - 10% brightness");
-		delay(2);
-		// Clear all LEDs first
-		myLedStrip.clear();
-		delay(2);
-		// Set all LEDs to red at 10% brightness (25 out of 255)
-		uint8_t redValue = 25;
-		for (int i = 0; i < ledStripNumpixels; i++) {
-			myLedStrip.setPixelColor(i, myLedStrip.Color(redValue, 0, 0));
+	if (data[0] == FRAME_RUNS) {
+		if ((length - 1) % 6 != 0) {
+			return false;
 		}
-		
-		// Disable interrupts briefly for clean NeoPixel update
-		noInterrupts();
-		myLedStrip.show();
-		interrupts();
-		
-		// Small delay to ensure clean data transmission
-		delay(10);
-		isInitialized = true;
-		lastUpdate = millis();
-		Serial.println("All LEDs set to red (10% brightness)");
-	}
-	
-	// Just maintain the display and handle periodic tasks
-	if (millis() - lastUpdate >= 100) {
-		lastUpdate = millis();
-		handleOTA();
-		handleWebServer();
-		feedWatchdog();
-	}
-	
-	// Check for animation change for better responsiveness
-	if (animationChanged) {
-		return; // Exit immediately if animation changed
-	}
-	
-	// Reset initialization when switching away from red mode
-	if (currentAnimation != ANIMATION_RED) {
-		isInitialized = false;
-		myLedStrip.clear();
-		myLedStrip.show();
-	}
-}
-
-// Matrix-style falling characters (green rain) across a 32x7 matrix
-// Runs for approximately `durationMs` milliseconds; stepDelayMs controls animation speed
-void animateMatrixRainMs(unsigned long durationMs, int stepDelayMs)
-{
-	static int head[32];
-	static bool isInitialized = false;
-	static unsigned long lastStep = 0;
-	
-	const int cols = 32;
-	const int rows = 7;
-	int tailLen = 3;
-	
-	// Initialize heads once
-	if (!isInitialized) {
-		for (int c = 0; c < cols; c++) head[c] = -random(1, rows + 1);
-		isInitialized = true;
-		lastStep = millis();
-	}
-	
-	// Only update animation if enough time has passed
-	if (millis() - lastStep >= (unsigned long)stepDelayMs) {
-		lastStep = millis();
-		
-		myLedStrip.clear();
-
-		for (int c = 0; c < cols; c++)
-		{
-			head[c]++;
-
-			if (head[c] > rows + random(2, 4) && random(0, 100) < 40)
-			{
-				head[c] = -random(1, rows);
-			}
-
-			for (int t = 0; t < tailLen; t++)
-			{
-				int row = head[c] - t;
-				if (row >= 0 && row < rows)
-				{
-					int idx = pixelIndex(c, row);
-					// Add safety bounds check for pixel index
-					if (idx >= 0 && idx < ledStripNumpixels) {
-						if (t == 0)
-						{
-							myLedStrip.setPixelColor(idx, myLedStrip.Color(180, 255, 180));
-						}
-						else
-						{
-							uint8_t g = (uint8_t)max(0, 200 - t * 50);
-							myLedStrip.setPixelColor(idx, myLedStrip.Color(0, g, 0));
-						}
-					}
-				}
+		for (size_t pos = 1; pos < length; pos += 6) {
+			uint16_t start = data[pos] | (data[pos + 1] << 8);
+			if (start + data[pos + 2] > MATRIX_PIXELS) {
+				return false;
 			}
 		}
-
-		myLedStrip.show();
-	}
-	
-	// Handle other tasks frequently
-	handleOTA();
-	handleWebServer();
-	
-	// Check for animation change for better responsiveness
-	if (animationChanged) {
-		return; // Exit immediately if animation changed
-	}
-	
-	// Reset initialization when switching away from matrix mode
-	if (currentAnimation != ANIMATION_MATRIX && currentAnimation != ANIMATION_AUTO) {
-		isInitialized = false;
+		return true;
 	}
+	return false;
 }
 
-// Calm burning fire effect across a 32x7 matrix
-void animateFireCalm(unsigned long durationMs, int stepDelayMs)
+// The whole body is checked before anything is written; false if it is malformed.
+bool setDrawingFrame(const uint8_t* data, size_t length)
 {
-	static int heat[32][7];
-	static bool isInitialized = false;
-	static unsigned long lastStep = 0;
-	
-	const int cols = 32;
-	const int rows = 7;
-	
-	// Initialize heat map once
-	if (!isInitialized) {
-		for (int c = 0; c < cols; c++) {
-			for (int r = 0; r < rows; r++) {
-				heat[c][r] = 0;
-			}
-		}
-		isInitialized = true;
-		lastStep = millis();
+	if (!isValidDrawingFrame(data, length)) {
+		return false;
 	}
-	
-	// Only update animation if enough time has passed
-	if (millis() - lastStep >= (unsigned long)stepDelayMs) {
-		lastStep = millis();
-		
-		// cool down and propagate upward
-		for (int c = 0; c < cols; c++)
-		{
-			// random ignition at the bottom
-			if (random(0, 100) < 20)
-			{
-				// smaller ignition bursts to reduce overall brightness
-				int add = (int)random(50, 140);
-				int v = heat[c][0] + add;
-				if (v > 255) v = 255;
-				heat[c][0] = v;
-			}
-
-			// propagate upwards with some decay
-			for (int r = rows - 1; r > 0; r--)
-			{
-				int a = heat[c][r - 1];
-				int b = (r > 1) ? heat[c][r - 2] : 0;
-				int val = (a + b) / 2;
-				// a little random flicker
-				{
-					int dec = (int)random(0, 30);
-					val = max(0, val - dec);
-				}
-				heat[c][r] = val;
-			}
 
-			// small decay at the bottom
-			{
-				int dec2 = (int)random(40, 100);
-				heat[c][0] = max(0, heat[c][0] - dec2);
+	if (data[0] == FRAME_FULL) {
+		const uint8_t* rgb = data + 1;
+		for (int row = 0; row < MATRIX_ROWS; row++) {
+			for (int col = 0; col < MATRIX_COLS; col++, rgb += 3) {
+				drawingGrid[col][row] = ((uint32_t)rgb[0] << 16) | ((uint32_t)rgb[1] << 8) | rgb[2];
 			}
 		}
-
-		// draw heatmap to LEDs
-		myLedStrip.clear();
-		for (int c = 0; c < cols; c++)
-		{
-			for (int r = 0; r < rows; r++)
-			{
-				int h = heat[c][r];
-				// Manual bounds checking instead of constrain
-				if (h < 0) h = 0;
-				if (h > 255) h = 255;
-				
-				// dimmer color mapping to lower overall brightness
-				uint8_t rcol = (uint8_t)min(255, h / 1);
-				uint8_t gcol = (uint8_t)min(255, h / 2);
-				uint8_t bcol = (uint8_t)min(60, h / 12);
-				int idx = pixelIndex(c, r);
-				myLedStrip.setPixelColor(idx, myLedStrip.Color(rcol, gcol, bcol));
-			}
-		}
-
-		myLedStrip.show();
-	}
-	
-	// Handle other tasks frequently
-	handleOTA();
-	handleWebServer();
-	feedWatchdog();
-	
-	// Check for animation change for better responsiveness
-	if (animationChanged) {
-		return; // Exit immediately if animation changed
-	}
-	
-	// Reset initialization when switching away from fire mode
-	if (currentAnimation != ANIMATION_FIRE && currentAnimation != ANIMATION_AUTO) {
-		isInitialized = false;
-	}
-}
-
-// Color picker mode - displays selected color on entire matrix
-void animateColorPicker(unsigned long durationMs)
-{
-	static unsigned long lastUpdate = 0;
-	
-	// Update display every 100ms
-	if (millis() - lastUpdate >= 100) {
-		lastUpdate = millis();
-		
-		// Fill entire matrix with selected color
-		myLedStrip.clear();
-		for (int i = 0; i < ledStripNumpixels; i++) {
-			myLedStrip.setPixelColor(i, selectedColor);
-		}
-		
-		myLedStrip.show();
-	}
-	
-	// Handle other tasks
-	handleOTA();
-	handleWebServer();
-	feedWatchdog();
-	
-	// Check for animation change for better responsiveness
-	if (animationChanged) {
-		return; // Exit immediately if animation changed
-	}
-}
-
-// Drawing mode - displays user-drawn image
-void animateDrawMode(unsigned long durationMs)
-{
-	static unsigned long lastUpdate = 0;
-	
-	// Update display when grid changes or every 500ms for tasks
-	if (needsGridUpdate || millis() - lastUpdate >= 500) {
-		lastUpdate = millis();
-		
-		if (needsGridUpdate) {
-			myLedStrip.clear();
-			
-// Draw pixels based on drawing grid with their stored colors
-            for (int col = 0; col < 32; col++) {
-                for (int row = 0; row < 7; row++) {
-                    if (drawingGrid[col][row] != 0) {
-                        int idx = pixelIndex(col, row);
-                        myLedStrip.setPixelColor(idx, drawingGrid[col][row]);
-					}
-				}
+	} else {
+		for (size_t pos = 1; pos < length; pos += 6) {
+			uint16_t start = data[pos] | (data[pos + 1] << 8);
+			uint32_t color = ((uint32_t)data[pos + 3] << 16) | ((uint32_t)data[pos + 4] << 8) | data[pos + 5];
+			for (uint16_t i = start; i < start + data[pos + 2]; i++) {
+				drawingGrid[i % MATRIX_COLS][i / MATRIX_COLS] = color;
 			}
-			
-			myLedStrip.show();
-			needsGridUpdate = false;
-		}
-	}
-	
-	// Handle other tasks
-	handleOTA();
-	handleWebServer();
-	feedWatchdog();
-	
-	// Check for animation change for better responsiveness
-	if (animationChanged) {
-		return; // Exit immediately if animation changed
-	}
-}
-
-// Clear the drawing grid
-void clearDrawingGrid()
-{
-	for (int col = 0; col < 32; col++) {
-		for (int row = 0; row < 7; row++) {
-			drawingGrid[col][row] = 0;  // 0 = off
 		}
 	}
-	needsGridUpdate = true;
-}
 
-// Set or clear a pixel in the drawing grid
-void setDrawingPixel(int col, int row, bool state)
-{
-	if (col >= 0 && col < 32 && row >= 0 && row < 7) {
-		drawingGrid[col][row] = state ? selectedColor : 0;  // Store color or 0 for off
-		needsGridUpdate = true;
-	}
+	return true;
 }
 
 // Watchdog callback function
@@ -851,177 +192,6 @@ void feedWatchdog() {
 	ESP.wdtFeed();
 }
 
-// Temperature animation - display temperature from AHT10 sensor
-void animateTemperature(unsigned long durationMs)
-{
-	static unsigned long lastUpdate = 0;
-	static float lastTemperature = -999.0;
-	
-	unsigned long now = millis();
-	if (now - lastUpdate >= durationMs) {
-		lastUpdate = now;
-		
-		if (ahtSensorAvailable) {
-			sensors_event_t humidity, temp;
-			if (aht.getEvent(&humidity, &temp)) {
-				float temperature = temp.temperature;
-				
-				// Only update display if temperature changed significantly or first reading
-				if (abs(temperature - lastTemperature) > 0.1 || lastTemperature == -999.0) {
-					lastTemperature = temperature;
-					currentTemperature = temperature;  // Update global variable
-					currentHumidity = humidity.relative_humidity;  // Update global humidity
-					Serial.print("Temperature: ");
-					Serial.print(temperature);
-					Serial.println(" °C");
-					
-					displayTemperatureDigits(temperature);
-				}
-			} else {
-				Serial.println("Failed to read from AHT10 sensor");
-				displayTemperatureError();
-			}
-		} else {
-			displayTemperatureError();
-		}
-	}
-	
-	// Handle periodic tasks
-	if (millis() - lastUpdate >= 100) {
-		handleOTA();
-		handleWebServer();
-		feedWatchdog();
-	}
-}
-
-// Display temperature as digits on LED matrix
-void displayTemperatureDigits(float temperature)
-{
-	myLedStrip.clear();
-	
-	// Round temperature to 1 decimal place
-	int temp10 = (int)(temperature * 10 + 0.5);
-	int digit1 = (temp10 / 100) % 10;  // tens
-	int digit2 = (temp10 / 10) % 10;   // units
-	int digit3 = temp10 % 10;          // decimal
-	
-	uint32_t digitColor = myLedStrip.Color(0, 255, 100); // Green-cyan color
-	uint32_t decimalColor = myLedStrip.Color(255, 100, 0); // Orange for decimal point
-	
-	// Define 7-segment display patterns for digits (5x7 matrix)
-	const bool digits[10][5][7] = {
-		// 0
-		{{0,1,1,1,0,0,0}, {1,0,0,0,1,0,0}, {1,0,0,0,1,0,0}, {1,0,0,0,1,0,0}, {0,1,1,1,0,0,0}},
-		// 1
-		{{0,0,1,0,0,0,0}, {0,1,1,0,0,0,0}, {0,0,1,0,0,0,0}, {0,0,1,0,0,0,0}, {0,1,1,1,0,0,0}},
-		// 2
-		{{0,1,1,1,0,0,0}, {1,0,0,0,1,0,0}, {0,0,1,1,0,0,0}, {0,1,0,0,0,0,0}, {1,1,1,1,1,0,0}},
-		// 3
-		{{0,1,1,1,0,0,0}, {1,0,0,0,1,0,0}, {0,0,1,1,0,0,0}, {1,0,0,0,1,0,0}, {0,1,1,1,0,0,0}},
-		// 4
-		{{1,0,0,1,0,0,0}, {1,0,0,1,0,0,0}, {1,1,1,1,1,0,0}, {0,0,0,1,0,0,0}, {0,0,0,1,0,0,0}},
-		// 5
-		{{1,1,1,1,1,0,0}, {1,0,0,0,0,0,0}, {1,1,1,1,0,0,0}, {0,0,0,0,1,0,0}, {1,1,1,1,0,0,0}},
-		// 6
-		{{0,1,1,1,0,0,0}, {1,0,0,0,0,0,0}, {1,1,1,1,0,0,0}, {1,0,0,0,1,0,0}, {0,1,1,1,0,0,0}},
-		// 7
-		{{1,1,1,1,1,0,0}, {0,0,0,0,1,0,0}, {0,0,0,1,0,0,0}, {0,0,1,0,0,0,0}, {0,0,1,0,0,0,0}},
-		// 8
-		{{0,1,1,1,0,0,0}, {1,0,0,0,1,0,0}, {0,1,1,1,0,0,0}, {1,0,0,0,1,0,0}, {0,1,1,1,0,0,0}},
-		// 9
-		{{0,1,1,1,0,0,0}, {1,0,0,0,1,0,0}, {0,1,1,1,1,0,0}, {0,0,0,0,1,0,0}, {0,1,1,1,0,0,0}}
-	};
-	
-	// Display digits: tens at x=2-6, units at x=10-14, decimal at x=18-22
-	// Tens digit (if not zero or if temperature >= 10)
-	if (digit1 > 0 || temp10 >= 100) {
-		for (int y = 0; y < 5; y++) {
-			for (int x = 0; x < 5; x++) {
-				if (digits[digit1][x][y]) {
-					int pixelX = 2 + x;
-					int pixelY = 1 + y;
-					if (pixelX < 32 && pixelY < 7) {
-						myLedStrip.setPixelColor(pixelIndex(pixelX, pixelY), digitColor);
-					}
-				}
-			}
-		}
-	}
-	
-	// Units digit
-	for (int y = 0; y < 5; y++) {
-		for (int x = 0; x < 5; x++) {
-			if (digits[digit2][x][y]) {
-				int pixelX = 9 + x;
-				int pixelY = 1 + y;
-				if (pixelX < 32 && pixelY < 7) {
-					myLedStrip.setPixelColor(pixelIndex(pixelX, pixelY), digitColor);
-				}
-			}
-		}
-	}
-	
-	// Decimal point
-	myLedStrip.setPixelColor(pixelIndex(15, 5), decimalColor);
-	
-	// Decimal digit
-	for (int y = 0; y < 5; y++) {
-		for (int x = 0; x < 5; x++) {
-			if (digits[digit3][x][y]) {
-				int pixelX = 17 + x;
-				int pixelY = 1 + y;
-				if (pixelX < 32 && pixelY < 7) {
-					myLedStrip.setPixelColor(pixelIndex(pixelX, pixelY), digitColor);
-				}
-			}
-		}
-	}
-	
-	// Display "°C" at the end
-	// Simple ° symbol at x=24, C at x=26-28
-	myLedStrip.setPixelColor(pixelIndex(24, 1), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(25, 1), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(24, 2), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(25, 2), myLedStrip.Color(255, 255, 255));
-	
-	// C letter
-	myLedStrip.setPixelColor(pixelIndex(27, 1), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(28, 1), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(29, 1), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(27, 2), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(27, 3), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(27, 4), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(27, 5), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(28, 5), myLedStrip.Color(255, 255, 255));
-	myLedStrip.setPixelColor(pixelIndex(29, 5), myLedStrip.Color(255, 255, 255));
-	
-	myLedStrip.show();
-}
-
-// Display red wavy line when temperature reading fails
-void displayTemperatureError()
-{
-	static unsigned long lastWaveUpdate = 0;
-	static int waveOffset = 0;
-	
-	if (millis() - lastWaveUpdate >= 200) {
-		lastWaveUpdate = millis();
-		waveOffset = (waveOffset + 1) % 32;
-		
-		myLedStrip.clear();
-		
-		// Create a red wavy line across the middle
-		for (int x = 0; x < 32; x++) {
-			int y = 3 + (int)(sin((x + waveOffset) * 0.5) * 1.5); // Wave oscillates around y=3
-			if (y >= 0 && y < 7) {
-				myLedStrip.setPixelColor(pixelIndex(x, y), myLedStrip.Color(255, 0, 0));
-			}
-		}
-		
-		myLedStrip.show();
-	}
-}
-
 void setup()
 {
 	Serial.begin(115200);
@@ -1033,8 +203,13 @@ void setup()
 	feedWatchdog();
 	Serial.println("Watchdog timer initialized");
 
-	myLedStrip.begin(); // This initializes the NeoPixel library.
-	myLedStrip.clear();
+	ledOutput.begin(); // This initializes the LED output (NeoPixel library or UART).
+#ifdef LED_OUTPUT_UART
+	// UART output sends in the background, so dithered frames can be refreshed at 250 Hz.
+	// Bit-bang output blocks with interrupts off for each frame and only dithers per animation frame.
+	frameBuffer.setRefreshInterval(4000);
+#endif
+	frameBuffer.clear();
 	
 
 	lastDebounceTime = millis();
@@ -1044,25 +219,12 @@ void setup()
 
 	connectWifi();
 	initWebServer();
+	streamReceiver.begin();
 	pinMode(ledStripPin, OUTPUT);
 
-	delay(2);
-
-	for (int i = 1; i < ledStripNumpixels; i++)
-	{
+	// Start from a dark strip
+	frameBuffer.show();
 
-		Serial.print(i);
-		Serial.print(" ");
-
-		myLedStrip.setPixelColor(i, myLedStrip.Color(255, 0, 0));
-		myLedStrip.show();
-		delay(10);
-		myLedStrip.setPixelColor(i, myLedStrip.Color(0, 0, 0));
-	}
-	delay(10);
-	myLedStrip.show();
-
-	Serial.println("pixend");
 		// Initialize I2C for AHT10 sensor
 	Wire.begin(AHT_SDA_PIN, AHT_SCL_PIN);
 	delay(100);
@@ -1075,120 +237,134 @@ void setup()
 		Serial.println("AHT10 temperature sensor not found - temperature animation will show error pattern");
 	}
 
+	AnimationRegistry::printFootprint();
+
+	// Effects draw their random numbers from seeds derived from this one
+	Prng::setBaseSeed(EFFECT_SEED);
+	Serial.print("Effect seed: ");
+	Serial.println(Prng::getBaseSeed());
+
+	// Period and CPU budget per task, in microseconds. Budgets are what each task is
+	// expected to stay under; overruns are counted and reported in /getStats.
+	scheduler.addTask("watchdog", watchdogTask, 100000, 100);
+	scheduler.addTask("wifi", wifiTask, 20000, 2000);
+	scheduler.addTask("ota", otaTask, 10000, 1000);
+	scheduler.addTask("http", httpTask, 2000, 20000);
+	scheduler.addTask("stream", streamTask, 2000, 3000);
+	scheduler.addTask("sensor", sensorTask, 1000000, 100000);
+	renderTaskId = scheduler.addTask("render", renderTask, frameClock.getFrameIntervalUs(), 8000);
+	scheduler.addTask("output", outputTask, 1000, 8000);
+	frameClock.restart();
 }
 
-void loop()
+// Scheduler tasks: everything loop() used to do inline, each with its own period
+void renderTask()
 {
-	// Check and feed watchdog
-	if (watchdogFlag || (millis() - lastWatchdogFeed > 5000)) {
-		feedWatchdog();
+	// A running self test borrows the effects; the strip holds its last frame meanwhile
+	if (SelfTest::isRunning()) {
+		SelfTest::slice();
+		return;
+	}
+
+	// Switch effects when the mode was changed via web interface
+	if (animationChanged || currentAnimation != animationPlayer.getMode()) {
+		animationChanged = false;
+		animationPlayer.select(currentAnimation);
+		// Effects may ask for their own frame rate
+		if (animationPlayer.targetFps() != frameClock.getTargetFps()) {
+			frameClock.setTargetFps(animationPlayer.targetFps());
+			scheduler.setPeriod(renderTaskId, frameClock.getFrameIntervalUs());
+		}
+		frameClock.restart();
+		Serial.print("Animation mode changed to: ");
+		Serial.println(getAnimationName(currentAnimation));
 	}
 
+	// The scheduler paces this task at the frame rate; the clock supplies dt
+	frameClock.setSpeed(animationSpeed);
+	frameClock.advance();
+	animationPlayer.frame(frameClock.dt());
+}
+
+// Send a frame the output backend was still too busy to take, otherwise re-send
+// the current one so temporal dithering keeps running between animation frames
+void outputTask()
+{
+	frameBuffer.update();
+}
+
+// Apply the commands the async web server and its WebSocket have queued since the
+// last run, and push state changes to the open pages
+void httpTask()
+{
+	handleWebServer();
+}
+
+// Realtime UDP frames; switches to and from the stream mode by itself
+void streamTask()
+{
+	streamReceiver.poll();
+}
+
+void otaTask()
+{
+	handleOTA();
+}
+
+void wifiTask()
+{
 	// Handle WiFi reconnection if connection is lost
 	handleWiFiReconnection();
 	
 	// Handle WiFi configuration button (hold for 3 seconds to reset WiFi settings)
 	handleWiFiConfigButton();
+}
 
-	handleOTA();
-	handleWebServer();
-
-	// Handle animation mode changes
-	static AnimationMode lastAnimation = ANIMATION_TEMPERATURE;
-	static unsigned long lastAnimationStart = 0;
-	static int autoAnimationIndex = 0;
-	const unsigned long AUTO_ANIMATION_DURATION = 10000; // 10 seconds per animation
-
-	// Check if animation was changed via web interface
-	if (animationChanged || currentAnimation != lastAnimation) {
-		animationChanged = false;
-		lastAnimation = currentAnimation;
-		lastAnimationStart = millis();
-		autoAnimationIndex = 0;
-		myLedStrip.clear();
-		myLedStrip.show();
-		Serial.print("Animation mode changed to: ");
-		Serial.println(getAnimationName(currentAnimation));
+// Read the AHT10. A read blocks for roughly 80 ms, so it runs every second only while
+// the temperature is on screen and every 30 seconds otherwise (for the web interface)
+void sensorTask()
+{
+	static unsigned long lastSample = 0;
+	static bool firstSample = true;
+	static float lastTemperature = -999.0;
+	
+	const Animation* shown = animationPlayer.visible();
+	bool visible = shown && shown->getMode() == ANIMATION_TEMPERATURE;
+	if (!ahtSensorAvailable || (!firstSample && !visible && millis() - lastSample < 30000)) {
+		return;
+	}
+	lastSample = millis();
+	firstSample = false;
+	
+	sensors_event_t humidity, temp;
+	if (aht.getEvent(&humidity, &temp)) {
+		float temperature = temp.temperature;
+		currentTemperature = temperature;  // Update global variable
+		currentHumidity = humidity.relative_humidity;  // Update global humidity
+		temperatureValid = true;
+		
+		// Only log if temperature changed significantly or first reading
+		if (abs(temperature - lastTemperature) > 0.1 || lastTemperature == -999.0) {
+			lastTemperature = temperature;
+			Serial.print("Temperature: ");
+			Serial.print(temperature);
+			Serial.println(" °C");
+		}
+	} else {
+		Serial.println("Failed to read from AHT10 sensor");
+		temperatureValid = false;
 	}
+}
 
-	// Run animations based on current mode
-	switch (currentAnimation) {
-		case ANIMATION_TEMPERATURE:
-			animateTemperature(1000); // Update temperature every second
-			break;
-			
-		case ANIMATION_QIX_LINES:
-			animateQixLines(250); // Shorter duration for better responsiveness
-			break;
-			
-		case ANIMATION_STARFIELD:
-			animateStarfield(50); // Shorter duration for better responsiveness
-			break;
-			
-		case ANIMATION_STAR_WARP:
-			animateStarWarp(250); // Shorter duration for better responsiveness
-			break;
-			
-		case ANIMATION_NEBULA:
-			animateNebula(250); // Shorter duration for better responsiveness
-			break;
-			
-		case ANIMATION_RED:
-			animateAllRed(250); // Shorter duration for better responsiveness
-			break;
-			
-		case ANIMATION_MATRIX:
-			animateMatrixRainMs(250L, (int)(90 / animationSpeed)); // Shorter duration
-			break;
-			
-		case ANIMATION_FIRE:
-			animateFireCalm(250UL, (int)(80 / animationSpeed)); // Shorter duration
-			break;
-			
-		case ANIMATION_COLOR_PICKER:
-			animateColorPicker(250); // Shorter duration for better responsiveness
-			break;
-			
-		case ANIMATION_DRAW_MODE:
-			animateDrawMode(250); // Shorter duration for better responsiveness
-			break;
-			
-		case ANIMATION_AUTO:
-		default:
-			// Auto cycle through animations starting with temperature
-			if (millis() - lastAnimationStart >= AUTO_ANIMATION_DURATION) {
-				lastAnimationStart = millis();
-				autoAnimationIndex = (autoAnimationIndex + 1) % 6;
-				myLedStrip.clear();
-				myLedStrip.show();
-				Serial.print("Auto switching to animation: ");
-				Serial.println(autoAnimationIndex);
-			}
-			
-			// Run current auto animation
-			switch (autoAnimationIndex) {
-				case 0:
-					animateTemperature(1000);  // Start auto cycle with temperature
-					break;
-				case 1:
-					animateStarfield(50);
-					break;
-				case 2:
-					animateStarWarp(50);
-					break;
-				case 3:
-					animateNebula(50);
-					break;
-				case 4:
-					animateMatrixRainMs(50L, (int)(90 / animationSpeed));
-					break;
-				case 5:
-					animateFireCalm(50UL, (int)(80 / animationSpeed));
-					break;
-			}
-			break;
+void watchdogTask()
+{
+	// Check and feed watchdog
+	if (watchdogFlag || (millis() - lastWatchdogFeed > 5000)) {
+		feedWatchdog();
 	}
+}
 
-	// Small delay for responsiveness
-	delay(10);
+void loop()
+{
+	scheduler.run();
 }
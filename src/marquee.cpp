@@ -0,0 +1,99 @@
+#include "marquee.h"
+#include "font.h"
+#include "matrix-geometry.h"
+
+Marquee marquee;
+
+Marquee::Marquee() {
+    text[0] = 0;
+    columns = nullptr;
+    columnCount = 0;
+    position = 0;
+    remainder = 0;
+    speed = 16;
+    color = 0xFFFFFF;
+    smooth = true;
+    setText("Hello from the balcony");
+}
+
+bool Marquee::setText(const char* message) {
+    // Fold UTF-8 into the font's character set
+    char folded[MAX_TEXT_LENGTH + 1];
+    uint16_t length = 0;
+    for (const uint8_t* p = (const uint8_t*)message; *p; p++) {
+        if (length == MAX_TEXT_LENGTH) {
+            return false;
+        }
+        if (p[0] == 0xC2 && p[1] == 0xB0) {
+            folded[length++] = FONT_DEGREE;
+            p++;
+        } else if (*p < 0x80) {
+            folded[length++] = *p;
+        } else if ((*p & 0xC0) != 0x80) {
+            // Lead byte of any other character; its continuation bytes are skipped
+            folded[length++] = '?';
+        }
+    }
+    folded[length] = 0;
+
+    const Font& font = FONT_5X7;
+    uint16_t width = Text::measure(font, folded);
+    delete[] columns;
+    columnCount = width + MATRIX_COLS;
+    columns = new uint8_t[columnCount];
+    memset(columns, 0, columnCount);
+
+    uint16_t x = 0;
+    for (uint16_t i = 0; i < length; i++) {
+        uint8_t start;
+        uint8_t glyphWidth = Text::glyphWidth(font, folded[i], &start);
+        for (uint8_t c = 0; c < glyphWidth; c++) {
+            columns[x + c] = Text::glyphColumn(font, folded[i], start + c);
+        }
+        x += glyphWidth + font.spacing;
+    }
+
+    memcpy(text, folded, length + 1);
+    restart();
+    return true;
+}
+
+void Marquee::restart() {
+    position = (uint32_t)(columnCount - MATRIX_COLS) << 8;
+    remainder = 0;
+}
+
+void Marquee::advance(uint32_t dtUs) {
+    uint64_t scaled = (uint64_t)dtUs * speed * 256 + remainder;
+    position += scaled / 1000000;
+    remainder = scaled % 1000000;
+    position %= (uint32_t)columnCount << 8;
+}
+
+void Marquee::render(Canvas& canvas) const {
+    canvas.clear();
+    Rgb16 full = colorPipeline.toLinear(color);
+    uint16_t first = position >> 8;
+    uint16_t fraction = smooth ? (position & 0xFF) : 0;
+
+    for (uint16_t x = 0; x < MATRIX_COLS; x++) {
+        uint16_t i = first + x;
+        if (i >= columnCount) i -= columnCount;
+        uint16_t next = (i + 1 < columnCount) ? i + 1 : 0;
+        uint8_t a = columns[i];
+        uint8_t b = fraction ? columns[next] : 0;
+        if (!(a | b)) continue;
+
+        for (uint16_t row = 0; row < MATRIX_ROWS; row++) {
+            uint16_t weight = ((a >> row) & 1) * (256 - fraction) + ((b >> row) & 1) * fraction;
+            if (weight == 0) continue;
+            Rgb16 c = full;
+            if (weight < 256) {
+                c.r = ((uint32_t)c.r * weight) >> 8;
+                c.g = ((uint32_t)c.g * weight) >> 8;
+                c.b = ((uint32_t)c.b * weight) >> 8;
+            }
+            canvas.setPixel(DisplayGeometry::table.index[row * MATRIX_COLS + x], c);
+        }
+    }
+}
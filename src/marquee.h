@@ -0,0 +1,48 @@
+// marquee.h - Scrolling text ticker rasterised once into a column bitmap
+#pragma once
+
+#include <Arduino.h>
+#include "canvas.h"
+
+// The message is rendered with the 5x7 font once, when it is set, into one byte per
+// column (bit 0 = top row) followed by a display-wide gap, so it scrolls in from the
+// right, leaves on the left and comes round again. Each frame only copies the
+// 32-column window at the scroll position. The position has 8 fractional bits;
+// with smoothing on, every output column mixes its two source columns by that
+// fraction, so slow scrolling glides instead of stepping a whole LED at a time.
+class Marquee {
+public:
+    static const uint16_t MAX_TEXT_LENGTH = 160;
+
+    Marquee();
+
+    // Rasterise a new message (UTF-8; '°' is supported, other non-ASCII shows as '?')
+    // and restart the scroll; false if it is too long
+    bool setText(const char* message);
+    const char* getText() const { return text; }
+
+    // Columns per second, at 1.0x animation speed
+    void setSpeed(uint16_t columnsPerSecond) { speed = columnsPerSecond; }
+    uint16_t getSpeed() const { return speed; }
+    void setColor(uint32_t color) { this->color = color; }
+    uint32_t getColor() const { return color; }
+    void setSmooth(bool enabled) { smooth = enabled; }
+    bool getSmooth() const { return smooth; }
+
+    // Start with the message just off the right edge
+    void restart();
+    void advance(uint32_t dtUs);
+    void render(Canvas& canvas) const;
+
+private:
+    char text[MAX_TEXT_LENGTH + 1];
+    uint8_t* columns;      // message columns, then the gap
+    uint16_t columnCount;
+    uint32_t position;     // scroll offset in 1/256 columns
+    uint32_t remainder;    // sub-step carry of the position, in 1/1000000
+    uint16_t speed;
+    uint32_t color;
+    bool smooth;
+};
+
+extern Marquee marquee;
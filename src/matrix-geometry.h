@@ -0,0 +1,89 @@
+// matrix-geometry.h - Compile-time LED matrix wiring and pixel index lookup
+#pragma once
+
+#include <stdint.h>
+#include <type_traits>
+
+// Wiring options, combined as flags in the Layout template argument
+enum MatrixLayout : uint8_t {
+    MATRIX_PROGRESSIVE  = 0x00,  // every row (or column) runs in the same direction
+    MATRIX_SERPENTINE   = 0x01,  // every other row (or column) runs backwards (zig-zag)
+    MATRIX_COLUMN_MAJOR = 0x02,  // strip runs along columns instead of rows
+    MATRIX_MIRROR_X     = 0x04,  // first LED is on the right
+    MATRIX_MIRROR_Y     = 0x08,  // first LED is at the bottom
+    MATRIX_ROTATE_90    = 0x10,  // panel mounted a quarter turn clockwise
+    MATRIX_ROTATE_180   = MATRIX_MIRROR_X | MATRIX_MIRROR_Y
+};
+
+// Maps logical (col, row), with (0, 0) at the top-left, to the LED's position on the
+// strip. The whole mapping is evaluated at compile time into a lookup table, so
+// index() is a single array read.
+template <uint16_t Cols, uint16_t Rows, uint8_t Layout>
+struct MatrixGeometry {
+    static constexpr uint16_t COLS = Cols;
+    static constexpr uint16_t ROWS = Rows;
+    static constexpr uint16_t PIXELS = Cols * Rows;
+
+    // Smallest type that can hold every strip index
+    typedef typename std::conditional<(PIXELS <= 256), uint8_t, uint16_t>::type index_t;
+
+    // Strip position for a logical pixel, computed from the layout flags
+    static constexpr uint16_t wireIndex(uint16_t col, uint16_t row) {
+        const bool rotated = (Layout & MATRIX_ROTATE_90) != 0;
+        // Panel dimensions as wired (swapped when mounted rotated)
+        const uint16_t panelCols = rotated ? Rows : Cols;
+        const uint16_t panelRows = rotated ? Cols : Rows;
+
+        uint16_t px = rotated ? (Rows - 1 - row) : col;
+        uint16_t py = rotated ? col : row;
+        if (Layout & MATRIX_MIRROR_X) px = panelCols - 1 - px;
+        if (Layout & MATRIX_MIRROR_Y) py = panelRows - 1 - py;
+
+        const bool columnMajor = (Layout & MATRIX_COLUMN_MAJOR) != 0;
+        const uint16_t major = columnMajor ? px : py;
+        const uint16_t runLength = columnMajor ? panelRows : panelCols;
+        uint16_t minor = columnMajor ? py : px;
+        if ((Layout & MATRIX_SERPENTINE) && (major & 1)) {
+            minor = runLength - 1 - minor;
+        }
+        return major * runLength + minor;
+    }
+
+    struct Table {
+        index_t index[PIXELS];
+        constexpr Table() : index() {
+            for (uint16_t row = 0; row < Rows; row++) {
+                for (uint16_t col = 0; col < Cols; col++) {
+                    index[row * Cols + col] = (index_t)wireIndex(col, row);
+                }
+            }
+        }
+    };
+
+    static constexpr Table table{};
+
+    static constexpr bool inBounds(int col, int row) {
+        return col >= 0 && col < Cols && row >= 0 && row < Rows;
+    }
+
+    // Unchecked lookup for hot loops; col/row must already be in range
+    static inline uint16_t index(uint16_t col, uint16_t row) {
+        return table.index[row * Cols + col];
+    }
+
+    // Lookup that clamps out-of-range coordinates to the nearest edge
+    static inline uint16_t indexClamped(int col, int row) {
+        if (col < 0) col = 0;
+        if (col >= Cols) col = Cols - 1;
+        if (row < 0) row = 0;
+        if (row >= Rows) row = Rows - 1;
+        return index(col, row);
+    }
+};
+
+// The balcony panel: 32x7, LED 0 top-left, rows alternate direction
+typedef MatrixGeometry<32, 7, MATRIX_SERPENTINE> DisplayGeometry;
+
+constexpr uint16_t MATRIX_COLS = DisplayGeometry::COLS;
+constexpr uint16_t MATRIX_ROWS = DisplayGeometry::ROWS;
+constexpr uint16_t MATRIX_PIXELS = DisplayGeometry::PIXELS;
@@ -0,0 +1,89 @@
+#include "overlay.h"
+#include "matrix-geometry.h"
+#include "trig-lut.h"
+
+Overlay overlay;
+
+Overlay::Overlay() {
+    memset(sprites, 0, sizeof(sprites));
+}
+
+void Overlay::showCorners(OverlaySlot slot, uint32_t color, OverlayStyle style,
+                          uint16_t periodMs, uint32_t durationMs) {
+    Sprite& sprite = sprites[slot];
+    sprite.style = style;
+    sprite.pixelCount = 4;
+    sprite.pixels[0] = DisplayGeometry::index(0, 0);
+    sprite.pixels[1] = DisplayGeometry::index(MATRIX_COLS - 1, 0);
+    sprite.pixels[2] = DisplayGeometry::index(0, MATRIX_ROWS - 1);
+    sprite.pixels[3] = DisplayGeometry::index(MATRIX_COLS - 1, MATRIX_ROWS - 1);
+    sprite.color = color;
+    sprite.periodMs = periodMs ? periodMs : 1;
+    sprite.durationMs = durationMs;
+    sprite.startMs = millis();
+    sprite.active = true;
+}
+
+void Overlay::remove(OverlaySlot slot) {
+    sprites[slot].active = false;
+}
+
+bool Overlay::active() const {
+    for (uint8_t i = 0; i < OVERLAY_SLOT_COUNT; i++) {
+        if (sprites[i].active) return true;
+    }
+    return false;
+}
+
+uint32_t Overlay::currentColor(Sprite& sprite, unsigned long now) {
+    if (!sprite.active) {
+        return 0;
+    }
+    uint32_t age = now - sprite.startMs;
+    if (sprite.durationMs != 0 && age >= sprite.durationMs) {
+        sprite.active = false;
+        return 0;
+    }
+
+    uint32_t phase = age % sprite.periodMs;
+    switch (sprite.style) {
+        case OVERLAY_BLINK:
+            return (phase < sprite.periodMs / 2u) ? sprite.color : 0;
+        case OVERLAY_PULSE: {
+            // Raised cosine, starting dark
+            uint16_t angle = (uint16_t)((phase << 16) / sprite.periodMs);
+            uint16_t level = (uint16_t)((32767 - cos16(angle)) >> 7);  // 0..511
+            uint8_t r = ((sprite.color >> 16) & 0xFF) * level >> 9;
+            uint8_t g = ((sprite.color >> 8) & 0xFF) * level >> 9;
+            uint8_t b = (sprite.color & 0xFF) * level >> 9;
+            return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+        }
+        default:
+            return sprite.color;
+    }
+}
+
+bool Overlay::changed() {
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < OVERLAY_SLOT_COUNT; i++) {
+        Sprite& sprite = sprites[i];
+        if (currentColor(sprite, now) != sprite.lastDrawn) return true;
+    }
+    return false;
+}
+
+void Overlay::compose(uint32_t* pixels, uint16_t count) {
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < OVERLAY_SLOT_COUNT; i++) {
+        Sprite& sprite = sprites[i];
+        uint32_t color = currentColor(sprite, now);
+        sprite.lastDrawn = color;
+        // An off phase lets the effect show through
+        if (color == 0) continue;
+        for (uint8_t p = 0; p < sprite.pixelCount; p++) {
+            if (sprite.pixels[p] < count) {
+                pixels[sprite.pixels[p]] = color;
+            }
+        }
+    }
+}
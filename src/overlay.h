@@ -0,0 +1,61 @@
+// overlay.h - Timed status sprites composited on top of the running effect
+#pragma once
+
+#include <Arduino.h>
+
+// One slot per kind of indicator; showing a sprite replaces whatever that slot held
+enum OverlaySlot : uint8_t {
+    OVERLAY_WIFI,
+    OVERLAY_SLOT_COUNT
+};
+
+enum OverlayStyle : uint8_t {
+    OVERLAY_SOLID,  // constant colour
+    OVERLAY_BLINK,  // on for the first half of each period, off for the second
+    OVERLAY_PULSE   // fades between off and the colour once per period
+};
+
+// Status indicators (WiFi connecting, connected, lost, config mode) are small
+// sprites with a style and a lifetime instead of code writing the strip and
+// sleeping. The frame buffer composites live sprites over each outgoing frame
+// after the colour pipeline, so they are neither dimmed by master brightness nor
+// stored in the effect's pixels, and sprites drop out by themselves when their
+// duration ends.
+class Overlay {
+public:
+    static const uint8_t MAX_SPRITE_PIXELS = 4;
+
+    Overlay();
+
+    // Show a sprite on the four matrix corners. Colour is 0x00RRGGBB as sent to the
+    // strip; durationMs 0 keeps it until remove().
+    void showCorners(OverlaySlot slot, uint32_t color, OverlayStyle style,
+                     uint16_t periodMs, uint32_t durationMs);
+    void remove(OverlaySlot slot);
+    bool active() const;
+
+    // True when the composited result differs from what was last drawn, i.e. a
+    // frame needs to go out even if the effect has not changed
+    bool changed();
+    // Draw live sprites over an outgoing frame (strip order, 0x00RRGGBB)
+    void compose(uint32_t* pixels, uint16_t count);
+
+private:
+    struct Sprite {
+        bool active;
+        OverlayStyle style;
+        uint8_t pixelCount;
+        uint16_t pixels[MAX_SPRITE_PIXELS];
+        uint32_t color;
+        uint16_t periodMs;
+        uint32_t durationMs;
+        unsigned long startMs;
+        uint32_t lastDrawn;  // colour as last composited, 0 = nothing drawn
+    };
+
+    Sprite sprites[OVERLAY_SLOT_COUNT];
+
+    uint32_t currentColor(Sprite& sprite, unsigned long now);
+};
+
+extern Overlay overlay;
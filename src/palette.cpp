@@ -0,0 +1,111 @@
+#include "palette.h"
+
+PaletteBank palettes;
+
+static constexpr PaletteStop EMBER_STOPS[] = {
+    {0, 0x000000}, {255, 0xFF7F15}
+};
+static constexpr PaletteStop HEAT_STOPS[] = {
+    {0, 0x000000}, {85, 0xFF0000}, {170, 0xFFFF00}, {255, 0xFFFFFF}
+};
+// Sampled from the three-phase sine rainbow Nebula used to compute per pixel
+static constexpr PaletteStop NEBULA_STOPS[] = {
+    {0, 0x5AED23}, {17, 0x76C91D}, {34, 0x959929}, {51, 0xAF6543},
+    {68, 0xC13567}, {85, 0xC7118F}, {102, 0xC100B5}, {119, 0xB005D1},
+    {136, 0x961FDE}, {153, 0x7749DB}, {170, 0x5B7CC9}, {187, 0x43B0A9},
+    {204, 0x37DB82}, {221, 0x36F65A}, {238, 0x42FD39}, {255, 0x58EE23}
+};
+static constexpr PaletteStop RAINBOW_STOPS[] = {
+    {0, 0xFF0000}, {17, 0xFF6600}, {34, 0xFFCC00}, {51, 0xCDFF00},
+    {68, 0x67FF00}, {85, 0x01FF00}, {102, 0x00FF64}, {119, 0x00FFCA},
+    {136, 0x00CFFF}, {153, 0x0069FF}, {170, 0x0003FF}, {187, 0x6200FF},
+    {204, 0xC800FF}, {221, 0xFF00D1}, {238, 0xFF006B}, {255, 0xFF0005}
+};
+static constexpr PaletteStop OCEAN_STOPS[] = {
+    {0, 0x000010}, {64, 0x002060}, {128, 0x0060A0}, {192, 0x00A0C0}, {255, 0x80FFFF}
+};
+
+static constexpr Palette EMBER_PALETTE PROGMEM(EMBER_STOPS);
+static constexpr Palette HEAT_PALETTE PROGMEM(HEAT_STOPS);
+static constexpr Palette NEBULA_PALETTE PROGMEM(NEBULA_STOPS);
+static constexpr Palette RAINBOW_PALETTE PROGMEM(RAINBOW_STOPS);
+static constexpr Palette OCEAN_PALETTE PROGMEM(OCEAN_STOPS);
+
+static const char* const PALETTE_NAMES[PALETTE_COUNT] = {
+    "ember", "heat", "nebula", "rainbow", "ocean", "custom"
+};
+
+uint32_t hsvToRgb(uint8_t hue, uint8_t saturation, uint8_t value) {
+    // Six sectors of the hue circle; rem is the position inside one, 0..255
+    uint16_t h6 = hue * 6;
+    uint8_t sector = h6 >> 8;
+    uint8_t rem = h6 & 0xFF;
+
+    uint8_t p = (value * (255 - saturation)) >> 8;
+    uint8_t q = (value * (255 - ((saturation * rem) >> 8))) >> 8;
+    uint8_t t = (value * (255 - ((saturation * (255 - rem)) >> 8))) >> 8;
+
+    uint8_t r, g, b;
+    switch (sector) {
+        case 0: r = value; g = t; b = p; break;
+        case 1: r = q; g = value; b = p; break;
+        case 2: r = p; g = value; b = t; break;
+        case 3: r = p; g = q; b = value; break;
+        case 4: r = t; g = p; b = value; break;
+        default: r = value; g = p; b = q; break;
+    }
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+void Palette::set(const PaletteStop* stops, uint8_t count) {
+    for (uint16_t i = 0; i < 256; i++) {
+        entries[i] = sample(stops, count, i);
+    }
+}
+
+PaletteBank::PaletteBank() : custom(nullptr) {
+    for (int mode = 0; mode < ANIMATION_MODE_COUNT; mode++) {
+        assigned[mode] = PALETTE_RAINBOW;
+    }
+    assigned[ANIMATION_FIRE] = PALETTE_EMBER;
+    assigned[ANIMATION_NEBULA] = PALETTE_NEBULA;
+}
+
+const Palette& PaletteBank::get(PaletteId id) const {
+    switch (id) {
+        case PALETTE_EMBER: return EMBER_PALETTE;
+        case PALETTE_HEAT: return HEAT_PALETTE;
+        case PALETTE_NEBULA: return NEBULA_PALETTE;
+        case PALETTE_OCEAN: return OCEAN_PALETTE;
+        case PALETTE_CUSTOM: if (custom) return *custom; break;
+        default: break;
+    }
+    return RAINBOW_PALETTE;
+}
+
+bool PaletteBank::setCustom(const PaletteStop* stops, uint8_t count) {
+    if (count == 0 || count > Palette::MAX_STOPS) {
+        return false;
+    }
+    for (uint8_t s = 1; s < count; s++) {
+        if (stops[s].position < stops[s - 1].position) {
+            return false;
+        }
+    }
+    if (!custom) {
+        custom = new Palette();
+    }
+    custom->set(stops, count);
+    return true;
+}
+
+const char* PaletteBank::getName(PaletteId id) {
+    return id < PALETTE_COUNT ? PALETTE_NAMES[id] : "unknown";
+}
+
+PaletteId PaletteBank::find(const String& name) {
+    for (uint8_t id = 0; id < PALETTE_COUNT; id++) {
+        if (name == PALETTE_NAMES[id]) return (PaletteId)id;
+    }
+    return PALETTE_COUNT;
+}
@@ -0,0 +1,108 @@
+// palette.h - 256-entry colour gradients in flash, integer colour blend and HSV
+#pragma once
+
+#include <Arduino.h>
+#include "webserver.h"
+
+// One gradient stop: position 0..255 along the palette and its colour (0x00RRGGBB)
+struct PaletteStop {
+    uint8_t position;
+    uint32_t color;
+};
+
+// Scale a 0x00RRGGBB colour by scale / 256 (255 is all but identity)
+inline uint32_t scaleColor(uint32_t color, uint8_t scale) {
+    uint16_t s = scale + 1;
+    return ((((color >> 16) & 0xFF) * s >> 8) << 16) |
+           ((((color >> 8) & 0xFF) * s >> 8) << 8) |
+           ((color & 0xFF) * s >> 8);
+}
+
+// Mix from a towards b by amount / 256
+constexpr uint32_t blendColor(uint32_t a, uint32_t b, uint16_t amount) {
+    return ((((a >> 16) & 0xFF) * (256 - amount) + ((b >> 16) & 0xFF) * amount) >> 8 << 16) |
+           ((((a >> 8) & 0xFF) * (256 - amount) + ((b >> 8) & 0xFF) * amount) >> 8 << 8) |
+           (((a & 0xFF) * (256 - amount) + (b & 0xFF) * amount) >> 8);
+}
+
+// Hue, saturation and value all 0..255; integer only, no division
+uint32_t hsvToRgb(uint8_t hue, uint8_t saturation, uint8_t value);
+
+// A gradient of up to 16 stops expanded into 256 colours, so colouring a pixel by
+// some 8-bit quantity (heat, hue, phase) is a single table read. Built-in palettes
+// are expanded at compile time and placed in flash; uploaded ones live in RAM.
+// get() works for both.
+class Palette {
+public:
+    static const uint8_t MAX_STOPS = 16;
+
+    Palette() : entries() {}
+    template<size_t N>
+    constexpr Palette(const PaletteStop (&stops)[N]) : entries() {
+        static_assert(N > 0 && N <= MAX_STOPS, "a palette takes 1 to 16 stops");
+        for (uint16_t i = 0; i < 256; i++) {
+            entries[i] = sample(stops, N, i);
+        }
+    }
+
+    // Expand stops (positions ascending) into this palette at run time
+    void set(const PaletteStop* stops, uint8_t count);
+
+    uint32_t get(uint8_t index) const { return pgm_read_dword(&entries[index]); }
+    // Colour at a 16-bit position, mixing the two nearest entries
+    uint32_t get16(uint16_t position) const {
+        uint8_t i = position >> 8;
+        return blendColor(get(i), get(i == 255 ? 255 : i + 1), position & 0xFF);
+    }
+
+    // Colour at index of the gradient through stops; before the first and after the
+    // last stop the end colours are held
+    static constexpr uint32_t sample(const PaletteStop* stops, uint8_t count, uint8_t index) {
+        if (index <= stops[0].position) return stops[0].color;
+        for (uint8_t s = 1; s < count; s++) {
+            if (index <= stops[s].position) {
+                uint8_t span = stops[s].position - stops[s - 1].position;
+                uint16_t amount = span ? ((index - stops[s - 1].position) * 256 + span / 2) / span : 256;
+                return blendColor(stops[s - 1].color, stops[s].color, amount);
+            }
+        }
+        return stops[count - 1].color;
+    }
+
+private:
+    uint32_t entries[256];
+};
+
+enum PaletteId : uint8_t {
+    PALETTE_EMBER,    // black to orange, the original Fire colours
+    PALETTE_HEAT,     // black, red, yellow, white
+    PALETTE_NEBULA,   // purple-biased rainbow, the original Nebula colours
+    PALETTE_RAINBOW,
+    PALETTE_OCEAN,
+    PALETTE_CUSTOM,   // uploaded through the web API; rainbow until then
+    PALETTE_COUNT
+};
+
+// The built-in palettes, the uploaded one and which palette each effect colours with
+class PaletteBank {
+public:
+    PaletteBank();
+
+    const Palette& get(PaletteId id) const;
+    const Palette& forEffect(AnimationMode mode) const { return get(assigned[mode]); }
+    PaletteId getAssigned(AnimationMode mode) const { return assigned[mode]; }
+    void assign(AnimationMode mode, PaletteId id) { assigned[mode] = id; }
+
+    // Replace the custom palette; false if the stops are unusable
+    bool setCustom(const PaletteStop* stops, uint8_t count);
+
+    static const char* getName(PaletteId id);
+    // PALETTE_COUNT if no palette has that name
+    static PaletteId find(const String& name);
+
+private:
+    PaletteId assigned[ANIMATION_MODE_COUNT];
+    Palette* custom;  // allocated on first upload
+};
+
+extern PaletteBank palettes;
@@ -0,0 +1,58 @@
+#include "power-limiter.h"
+
+PowerLimiter powerLimiter(POWER_LIMIT_MA);
+
+PowerLimiter::PowerLimiter(uint32_t limitMa) : limitMa(limitMa) {
+    requestedMa = 0;
+    shownMa = 0;
+    limitedFrames = 0;
+    chargeMaMs = 0;
+    shownSince = 0;
+}
+
+uint32_t PowerLimiter::estimate(const uint32_t* pixels, uint16_t count) const {
+    uint32_t sumR = 0, sumG = 0, sumB = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t c = pixels[i];
+        sumR += (c >> 16) & 0xFF;
+        sumG += (c >> 8) & 0xFF;
+        sumB += c & 0xFF;
+    }
+    return (sumR * MA_RED + sumG * MA_GREEN + sumB * MA_BLUE) / 255 + (uint32_t)count * MA_IDLE;
+}
+
+bool PowerLimiter::apply(uint32_t* pixels, uint16_t count) {
+    // Close the energy interval of the frame that was on the strip until now
+    unsigned long now = millis();
+    chargeMaMs += (uint64_t)shownMa * (now - shownSince);
+    shownSince = now;
+
+    requestedMa = estimate(pixels, count);
+    shownMa = requestedMa;
+
+    uint32_t idleMa = (uint32_t)count * MA_IDLE;
+    if (requestedMa <= limitMa) {
+        return false;
+    }
+
+    // Only the channel current scales; the idle draw stays, so a limit at or
+    // below it leaves nothing for the channels
+    uint32_t scale = limitMa > idleMa ? ((limitMa - idleMa) << 8) / (requestedMa - idleMa) : 0; // 8.8, < 256
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t c = pixels[i];
+        uint32_t r = (((c >> 16) & 0xFF) * scale) >> 8;
+        uint32_t g = (((c >> 8) & 0xFF) * scale) >> 8;
+        uint32_t b = ((c & 0xFF) * scale) >> 8;
+        pixels[i] = (r << 16) | (g << 8) | b;
+    }
+
+    shownMa = estimate(pixels, count);
+    limitedFrames++;
+    return true;
+}
+
+float PowerLimiter::getWattHours() const {
+    uint64_t total = chargeMaMs + (uint64_t)shownMa * (millis() - shownSince);
+    // mA * ms -> mAh is / 3 600 000, then * V / 1000 for Wh
+    return (float)total * SUPPLY_VOLTS / 3600000000.0f;
+}
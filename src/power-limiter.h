@@ -0,0 +1,57 @@
+// power-limiter.h - Per-frame LED current estimate and automatic brightness limit
+#pragma once
+
+#include <Arduino.h>
+
+// Supply current available to the strip, in mA; override with -DPOWER_LIMIT_MA=...
+#ifndef POWER_LIMIT_MA
+#define POWER_LIMIT_MA 2500
+#endif
+
+// Estimates strip current from the frame with a per-channel model (mA drawn by
+// each channel at full level, plus a quiescent draw per LED) and, if the frame
+// would exceed the supply limit, scales all channels down so it fits. Energy is
+// integrated over time from the estimate of whatever frame is on the strip.
+class PowerLimiter {
+public:
+    // WS2812B at 5 V, full level per channel, and idle draw per LED
+    static const uint16_t MA_RED = 16;
+    static const uint16_t MA_GREEN = 11;
+    static const uint16_t MA_BLUE = 15;
+    static const uint16_t MA_IDLE = 1;
+    static const uint16_t SUPPLY_VOLTS = 5;
+    // Limits accepted at build time and from the control API
+    static const uint16_t MIN_LIMIT_MA = 500;
+    static const uint16_t MAX_LIMIT_MA = 15000;
+
+    PowerLimiter(uint32_t limitMa);
+
+    void setLimit(uint32_t limitMa) { this->limitMa = limitMa; }
+    uint32_t getLimit() const { return limitMa; }
+
+    // Current the frame would draw unscaled, in mA (one pass over the pixels)
+    uint32_t estimate(const uint32_t* pixels, uint16_t count) const;
+
+    // Called with each frame about to be sent. Scales the pixels in place when the
+    // frame is over budget, down to black if the limit does not even cover the
+    // idle draw; returns true if it did.
+    bool apply(uint32_t* pixels, uint16_t count);
+
+    uint32_t getEstimatedMa() const { return shownMa; }     // after limiting
+    uint32_t getRequestedMa() const { return requestedMa; } // before limiting
+    unsigned long getLimitedFrames() const { return limitedFrames; }
+    float getWattHours() const;
+
+private:
+    uint32_t limitMa;
+    uint32_t requestedMa;
+    uint32_t shownMa;
+    unsigned long limitedFrames;
+    uint64_t chargeMaMs;      // integrated current of previous frames, mA * ms
+    unsigned long shownSince; // millis() when the current frame went out
+};
+
+static_assert(POWER_LIMIT_MA >= PowerLimiter::MIN_LIMIT_MA && POWER_LIMIT_MA <= PowerLimiter::MAX_LIMIT_MA,
+              "POWER_LIMIT_MA must be 500-15000 mA");
+
+extern PowerLimiter powerLimiter;
@@ -0,0 +1,43 @@
+#include "prng.h"
+
+uint32_t Prng::baseSeed = EFFECT_SEED;
+uint32_t Prng::generation = 0;
+
+void Prng::fill(uint8_t* buffer, size_t length) {
+    while (length >= 4) {
+        uint32_t r = next();
+        buffer[0] = r;
+        buffer[1] = r >> 8;
+        buffer[2] = r >> 16;
+        buffer[3] = r >> 24;
+        buffer += 4;
+        length -= 4;
+    }
+    if (length) {
+        uint32_t r = next();
+        while (length--) {
+            *buffer++ = r;
+            r >>= 8;
+        }
+    }
+}
+
+// Finaliser from MurmurHash3: spreads nearby inputs over the whole 32 bits
+static uint32_t mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6B;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35;
+    x ^= x >> 16;
+    return x;
+}
+
+uint32_t Prng::seedFor(uint8_t stream) {
+    generation++;
+    return mix32(baseSeed + stream * 0x9E3779B9 + (generation << 8));
+}
+
+void Prng::setBaseSeed(uint32_t base) {
+    baseSeed = base ? base : ESP.random();
+    generation = 0;
+}
@@ -0,0 +1,52 @@
+// prng.h - Small seedable random number generator for effect hot loops
+#pragma once
+
+#include <Arduino.h>
+
+// Base seed for effects; a non-zero -DEFFECT_SEED=... makes every run repeat exactly
+#ifndef EFFECT_SEED
+#define EFFECT_SEED 0
+#endif
+
+// xorshift32: three shifts and xors per number, no multiply or modulo, which makes
+// it several times cheaper than Arduino's random() on the LX106. Bounded helpers
+// scale the top 16 bits by multiply and shift instead of dividing, so bounds are
+// limited to 16 bits (more than any effect needs). Each effect keeps its own
+// generator in its state, seeded from seedFor() on begin(), so a fixed base seed
+// makes its output deterministic.
+class Prng {
+public:
+    explicit Prng(uint32_t seed = 1) { this->seed(seed); }
+
+    // xorshift32 must never hold 0
+    void seed(uint32_t seed) { state = seed ? seed : 0x9E3779B9; }
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // 0 .. bound-1
+    uint16_t below(uint16_t bound) { return ((next() >> 16) * bound) >> 16; }
+    // min .. max-1, same range as Arduino's random(min, max)
+    int32_t range(int32_t min, int32_t max) { return min + below(max - min); }
+    // True with the given chance in percent
+    bool chance(uint8_t percent) { return below(100) < percent; }
+    // Fill a buffer with random bytes, four per step
+    void fill(uint8_t* buffer, size_t length);
+
+    // Seed for one effect (or any other stream): mixed from the base seed, the stream
+    // and how many seeds were handed out since the base seed was set
+    static uint32_t seedFor(uint8_t stream);
+    // Restart every seed sequence from base; 0 takes one from the hardware RNG
+    static void setBaseSeed(uint32_t base);
+    static uint32_t getBaseSeed() { return baseSeed; }
+
+private:
+    uint32_t state;
+
+    static uint32_t baseSeed;
+    static uint32_t generation;
+};
@@ -0,0 +1,101 @@
+#include "scheduler.h"
+
+Scheduler scheduler;
+
+Scheduler::Scheduler() {
+    taskCount = 0;
+}
+
+int Scheduler::addTask(const char* name, TaskCallback callback, uint32_t periodUs, uint32_t budgetUs) {
+    if (taskCount >= MAX_TASKS) {
+        Serial.print("Scheduler: no slot for task ");
+        Serial.println(name);
+        return -1;
+    }
+
+    SchedulerTask& task = tasks[taskCount];
+    task.name = name;
+    task.callback = callback;
+    task.periodUs = periodUs;
+    task.budgetUs = budgetUs;
+    // Due on the first pass
+    task.lastRunUs = micros() - periodUs;
+    task.runs = 0;
+    task.overruns = 0;
+    task.lastUs = 0;
+    task.maxUs = 0;
+    task.totalUs = 0;
+    return taskCount++;
+}
+
+void Scheduler::setPeriod(int task, uint32_t periodUs) {
+    if (task >= 0 && task < taskCount) {
+        tasks[task].periodUs = periodUs;
+    }
+}
+
+void Scheduler::run() {
+    for (uint8_t i = 0; i < taskCount; i++) {
+        SchedulerTask& task = tasks[i];
+        uint32_t now = micros();
+        uint32_t sinceLast = now - task.lastRunUs;
+        if (sinceLast < task.periodUs) {
+            continue;
+        }
+
+        // Keep a fixed rate, but don't try to catch up after falling a whole period behind
+        if (sinceLast < 2 * task.periodUs) {
+            task.lastRunUs += task.periodUs;
+        } else {
+            task.lastRunUs = now;
+        }
+
+        task.callback();
+
+        uint32_t took = micros() - now;
+        task.runs++;
+        task.lastUs = took;
+        task.totalUs += took;
+        if (took > task.maxUs) {
+            task.maxUs = took;
+        }
+        if (task.budgetUs && took > task.budgetUs) {
+            task.overruns++;
+        }
+    }
+
+    // Sleep only for the time actually left; sub-millisecond gaps just yield
+    uint32_t idleUs = timeUntilNextTask();
+    if (idleUs >= 1000) {
+        delay(idleUs / 1000);
+    } else {
+        yield();
+    }
+}
+
+uint32_t Scheduler::timeUntilNextTask() const {
+    uint32_t now = micros();
+    uint32_t idleUs = UINT32_MAX;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const SchedulerTask& task = tasks[i];
+        uint32_t sinceLast = now - task.lastRunUs;
+        if (sinceLast >= task.periodUs) {
+            return 0;
+        }
+        uint32_t left = task.periodUs - sinceLast;
+        if (left < idleUs) {
+            idleUs = left;
+        }
+    }
+    return idleUs == UINT32_MAX ? 0 : idleUs;
+}
+
+void Scheduler::resetStats() {
+    for (uint8_t i = 0; i < taskCount; i++) {
+        tasks[i].runs = 0;
+        tasks[i].overruns = 0;
+        tasks[i].lastUs = 0;
+        tasks[i].maxUs = 0;
+        tasks[i].totalUs = 0;
+    }
+}
@@ -0,0 +1,52 @@
+// scheduler.h - Cooperative scheduler running loop() work as periodic tasks with CPU budgets
+#pragma once
+
+#include <Arduino.h>
+
+typedef void (*TaskCallback)();
+
+struct SchedulerTask {
+    const char* name;
+    TaskCallback callback;
+    uint32_t periodUs;     // 0 = run on every pass
+    uint32_t budgetUs;     // expected worst case; longer runs are counted as overruns
+    uint32_t lastRunUs;
+
+    uint32_t runs;
+    uint32_t overruns;
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+
+    uint32_t averageUs() const { return runs ? (uint32_t)(totalUs / runs) : 0; }
+};
+
+// Runs every registered task whose period has elapsed, in registration order, and
+// records how long each one took. Between passes it sleeps (via delay(), which also
+// lets the WiFi stack run) only for the time left until the next task is due, so
+// every subsystem gets a bounded latency whatever the active animation costs.
+class Scheduler {
+public:
+    static const uint8_t MAX_TASKS = 12;
+
+    Scheduler();
+
+    // Returns the task slot, or -1 if the table is full
+    int addTask(const char* name, TaskCallback callback, uint32_t periodUs, uint32_t budgetUs);
+    void setPeriod(int task, uint32_t periodUs);
+
+    // One scheduler pass: run due tasks, then sleep until the next one is due
+    void run();
+
+    uint8_t getTaskCount() const { return taskCount; }
+    const SchedulerTask& getTask(uint8_t task) const { return tasks[task]; }
+    void resetStats();
+
+private:
+    SchedulerTask tasks[MAX_TASKS];
+    uint8_t taskCount;
+
+    uint32_t timeUntilNextTask() const;
+};
+
+extern Scheduler scheduler;
@@ -0,0 +1,124 @@
+#include "self-test.h"
+#include <LittleFS.h>
+#include "frame-profiler.h"
+
+const char* SelfTest::GOLDEN_FILENAME = "/golden-frames.bin";
+
+GoldenReplay SelfTest::replay;
+bool SelfTest::running = false;
+bool SelfTest::rebaseline = false;
+bool SelfTest::haveGolden = false;
+bool SelfTest::passed = false;
+String SelfTest::report;
+String SelfTest::lastReport;
+int SelfTest::firstMismatch = -1;
+uint32_t SelfTest::totalCycles = 0;
+uint32_t SelfTest::maxCycles = 0;
+
+// Golden hashes of the run; open while it is in progress
+static File golden;
+
+void SelfTest::start(bool rebaseline) {
+    if (running) {
+        Serial.println("Self test: already running");
+        return;
+    }
+
+    SelfTest::rebaseline = rebaseline;
+    haveGolden = false;
+    if (rebaseline) {
+        golden = LittleFS.open(GOLDEN_FILENAME, "w");
+        if (!golden) {
+            Serial.println("Self test: cannot write golden frames");
+            lastReport = "{\"error\":\"cannot write golden frames\",\"passed\":false}";
+            return;
+        }
+    } else if (LittleFS.exists(GOLDEN_FILENAME)) {
+        golden = LittleFS.open(GOLDEN_FILENAME, "r");
+        // A different suite or frame count makes old goldens meaningless
+        haveGolden = golden && golden.size() == (size_t)GoldenReplay::SUITE_LENGTH * GoldenReplay::FRAMES * sizeof(uint32_t);
+    }
+
+    // The replay needs the effects and their arena; the render task selects the
+    // effect again once the run is over
+    animationPlayer.stop();
+    replay.start();
+    running = true;
+    passed = true;
+    firstMismatch = -1;
+    totalCycles = 0;
+    maxCycles = 0;
+    report = "{\"frames\":" + String(GoldenReplay::FRAMES) + ",\"animations\":[";
+}
+
+void SelfTest::slice() {
+    for (uint8_t i = 0; i < FRAMES_PER_SLICE && running; i++) {
+        if (!replay.step()) {
+            finish();
+            break;
+        }
+
+        uint32_t hash = replay.getHash();
+        totalCycles += replay.getCycles();
+        if (replay.getCycles() > maxCycles) maxCycles = replay.getCycles();
+        if (rebaseline) {
+            golden.write((const uint8_t*)&hash, sizeof(hash));
+        } else if (haveGolden) {
+            uint32_t expected = 0;
+            golden.read((uint8_t*)&expected, sizeof(expected));
+            if (expected != hash && firstMismatch < 0) {
+                firstMismatch = replay.getFrame();
+            }
+        }
+
+        if (replay.isLastFrame()) {
+            finishEntry();
+        }
+    }
+}
+
+void SelfTest::finishEntry() {
+    Animation* animation = replay.getAnimation();
+    const char* status;
+    if (rebaseline) {
+        status = "baselined";
+    } else if (!haveGolden) {
+        status = "no golden";
+        passed = false;
+    } else if (firstMismatch >= 0) {
+        status = "fail";
+        passed = false;
+    } else {
+        status = "pass";
+    }
+
+    Serial.print("Self test ");
+    Serial.print(animation->getName());
+    Serial.print(": ");
+    Serial.println(status);
+
+    if (replay.getEntry() > 0) report += ",";
+    report += "{\"name\":\"" + String(animation->getName()) +
+              "\",\"status\":\"" + status +
+              "\",\"firstMismatch\":" + String(firstMismatch) +
+              ",\"lastHash\":\"" + String((unsigned long)replay.getHash(), HEX) +
+              "\",\"avgUs\":" + String(FrameProfiler::cyclesToMicros(totalCycles / GoldenReplay::FRAMES)) +
+              ",\"maxUs\":" + String(FrameProfiler::cyclesToMicros(maxCycles)) + "}";
+
+    firstMismatch = -1;
+    totalCycles = 0;
+    maxCycles = 0;
+}
+
+void SelfTest::finish() {
+    if (golden) {
+        golden.close();
+    }
+    running = false;
+
+    report += "],\"passed\":" + String(passed ? "true" : "false") + "}";
+    lastReport = report;
+    report = String();
+    Serial.print("Self test ");
+    Serial.println(rebaseline ? "baselined" : (passed ? "passed" : "failed"));
+}
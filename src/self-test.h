@@ -0,0 +1,42 @@
+// self-test.h - Golden-frame regression check of the effects, run on the device
+#pragma once
+
+#include <Arduino.h>
+#include "golden-frames.h"
+
+// Runs the golden replay (golden-frames.h) against the hashes stored in LittleFS, or
+// stores new ones. The replay borrows the effects, so while it runs the render task
+// hands its slices to slice() instead of drawing, and the strip holds its last frame.
+// Render time per frame is measured alongside, so the same run shows the speed-up.
+class SelfTest {
+public:
+    // Frames replayed per render task slice, to stay inside the task's budget
+    static const uint8_t FRAMES_PER_SLICE = 4;
+
+    // Begin a run; with rebaseline the hashes are stored as the new goldens
+    static void start(bool rebaseline);
+    static bool isRunning() { return running; }
+    // Replay the next few frames; finishes the report after the last one
+    static void slice();
+    // JSON report of the last finished run; empty before the first
+    static const String& getLastReport() { return lastReport; }
+
+private:
+    static const char* GOLDEN_FILENAME;
+
+    static GoldenReplay replay;
+    static bool running;
+    static bool rebaseline;
+    static bool haveGolden;
+    static bool passed;
+    static String report;
+    static String lastReport;
+
+    // Totals of the suite entry being replayed
+    static int firstMismatch;
+    static uint32_t totalCycles;
+    static uint32_t maxCycles;
+
+    static void finishEntry();
+    static void finish();
+};
@@ -0,0 +1,165 @@
+#include "stream-protocol.h"
+#include <string.h>
+
+// DDP header: flags, sequence, data type, destination, offset (32-bit), length (16-bit),
+// then a 32-bit timecode when the flag is set. Numbers are big-endian.
+static const size_t DDP_HEADER = 10;
+static const uint8_t DDP_VERSION_MASK = 0xC0;
+static const uint8_t DDP_VERSION_1 = 0x40;
+static const uint8_t DDP_TIMECODE = 0x10;
+static const uint8_t DDP_QUERY = 0x02;
+static const uint8_t DDP_PUSH = 0x01;
+static const uint8_t DDP_DEFAULT_OUTPUT = 1;
+
+// E1.31 data packet: root, framing and DMP layers at fixed offsets
+static const size_t E131_HEADER = 126;  // up to and including the DMX start code
+static const uint8_t E131_IDENTIFIER[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+static const uint8_t E131_OPTION_PREVIEW = 0x80;
+static const uint8_t E131_OPTION_TERMINATED = 0x40;
+
+static uint32_t readBig32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint16_t readBig16(const uint8_t* p) {
+    return (p[0] << 8) | p[1];
+}
+
+StreamDecoder::StreamDecoder(uint16_t firstUniverse) : firstUniverse(firstUniverse) {
+    memset(front, 0, sizeof(front));
+    memset(pending, 0, sizeof(pending));
+    pendingData = false;
+    packets = 0;
+    frames = 0;
+    late = 0;
+    invalid = 0;
+    reset();
+}
+
+void StreamDecoder::reset() {
+    ddpSequence = 0;
+    for (uint8_t u = 0; u < UNIVERSES; u++) {
+        e131Sequence[u] = -1;
+    }
+    lastUniverse = -1;
+}
+
+void StreamDecoder::write(uint32_t offset, const uint8_t* data, size_t length) {
+    if (offset >= CHANNELS) {
+        return;
+    }
+    if (length > CHANNELS - offset) {
+        length = CHANNELS - offset;
+    }
+    memcpy(pending + offset, data, length);
+    pendingData = true;
+}
+
+bool StreamDecoder::publish() {
+    if (!pendingData) {
+        return false;
+    }
+    memcpy(front, pending, CHANNELS);
+    pendingData = false;
+    frames++;
+    return true;
+}
+
+StreamResult StreamDecoder::receiveDdp(const uint8_t* packet, size_t length) {
+    if (length < DDP_HEADER || (packet[0] & DDP_VERSION_MASK) != DDP_VERSION_1 || (packet[0] & DDP_QUERY)) {
+        invalid++;
+        return STREAM_INVALID;
+    }
+    uint8_t destination = packet[3];
+    if (destination != DDP_DEFAULT_OUTPUT && destination != 0) {
+        invalid++;
+        return STREAM_INVALID;
+    }
+
+    // Sequence 1-15, 0 if the sender does not number packets; a packet up to 7
+    // behind the last one arrived out of order
+    uint8_t sequence = packet[1] & 0x0F;
+    if (sequence && ddpSequence) {
+        uint8_t behind = (ddpSequence - sequence + 15) % 15;
+        if (behind >= 1 && behind <= 7) {
+            late++;
+            return STREAM_LATE;
+        }
+    }
+    if (sequence) {
+        ddpSequence = sequence;
+    }
+
+    size_t header = DDP_HEADER + ((packet[0] & DDP_TIMECODE) ? 4 : 0);
+    if (length < header) {
+        invalid++;
+        return STREAM_INVALID;
+    }
+    uint32_t offset = readBig32(packet + 4);
+    size_t dataLength = readBig16(packet + 8);
+    // The receive buffer may have cut a long packet; the rest lies beyond the display
+    if (dataLength > length - header) {
+        dataLength = length - header;
+    }
+
+    packets++;
+    write(offset, packet + header, dataLength);
+    if ((packet[0] & DDP_PUSH) || offset + dataLength >= CHANNELS) {
+        return publish() ? STREAM_FRAME : STREAM_DATA;
+    }
+    return STREAM_DATA;
+}
+
+StreamResult StreamDecoder::receiveE131(const uint8_t* packet, size_t length) {
+    if (length < E131_HEADER || readBig16(packet) != 0x0010 ||
+        memcmp(packet + 4, E131_IDENTIFIER, sizeof(E131_IDENTIFIER)) != 0 ||
+        readBig32(packet + 18) != 0x00000004 ||   // root vector: E1.31 data
+        readBig32(packet + 40) != 0x00000002 ||   // framing vector: DMP
+        packet[117] != 0x02 ||                     // DMP vector: set property
+        packet[125] != 0) {                        // DMX start code: dimmer data
+        invalid++;
+        return STREAM_INVALID;
+    }
+
+    uint8_t options = packet[112];
+    uint16_t universe = readBig16(packet + 113);
+    if ((options & E131_OPTION_PREVIEW) || universe < firstUniverse || universe - firstUniverse >= UNIVERSES) {
+        invalid++;
+        return STREAM_INVALID;
+    }
+    // Only a source of our own universes can end the stream
+    if (options & E131_OPTION_TERMINATED) {
+        return STREAM_END;
+    }
+    uint8_t slot = universe - firstUniverse;
+
+    // E1.31 6.7.2: drop a packet 1 to 20 behind the last of its universe (or a repeat)
+    uint8_t sequence = packet[111];
+    if (e131Sequence[slot] >= 0) {
+        int8_t ahead = (int8_t)(sequence - (uint8_t)e131Sequence[slot]);
+        if (ahead <= 0 && ahead > -20) {
+            late++;
+            return STREAM_LATE;
+        }
+    }
+    e131Sequence[slot] = sequence;
+
+    // Property value count includes the start code
+    size_t count = readBig16(packet + 123);
+    size_t dataLength = count > 0 ? count - 1 : 0;
+    if (dataLength > length - E131_HEADER) {
+        dataLength = length - E131_HEADER;
+    }
+
+    packets++;
+    // Universes go out in order; one at or below the previous starts a new frame
+    bool frame = (int32_t)universe <= lastUniverse && publish();
+    lastUniverse = universe;
+
+    uint32_t offset = (uint32_t)slot * UNIVERSE_CHANNELS;
+    write(offset, packet + E131_HEADER, dataLength);
+    if (offset + dataLength >= CHANNELS) {
+        frame = publish() || frame;
+    }
+    return frame ? STREAM_FRAME : STREAM_DATA;
+}
@@ -0,0 +1,62 @@
+// stream-protocol.h - DDP and E1.31 (sACN) packet decoding into a frame of pixel channels
+#pragma once
+
+// Plain C++ only (no Arduino headers), so the decoder builds natively as well
+#include <stdint.h>
+#include <stddef.h>
+#include "matrix-geometry.h"
+
+enum StreamResult : uint8_t {
+    STREAM_INVALID,  // not a packet of the protocol, or not for this display
+    STREAM_LATE,     // sequence number behind the last one; dropped
+    STREAM_DATA,     // channels written, frame not complete yet
+    STREAM_FRAME,    // a complete frame is ready in frame()
+    STREAM_END       // an E1.31 source announced the end of its stream
+};
+
+// Collects the channel data of DDP or E1.31 packets into a pending buffer and
+// publishes it as the current frame when the sender marks the frame complete
+// (DDP push flag), when the data reaches the last channel, or when a new E1.31
+// frame starts. Channels are R, G, B per pixel in row order (row * MATRIX_COLS + col).
+// Packets whose sequence number is behind the previous one are dropped, so
+// reordered stale data never overwrites newer pixels.
+class StreamDecoder {
+public:
+    static const uint16_t CHANNELS = MATRIX_PIXELS * 3;
+    // E1.31 universes carry 170 RGB pixels each, as xLights and LedFx send them
+    static const uint16_t UNIVERSE_CHANNELS = 510;
+    static const uint8_t UNIVERSES = (CHANNELS + UNIVERSE_CHANNELS - 1) / UNIVERSE_CHANNELS;
+
+    explicit StreamDecoder(uint16_t firstUniverse = 1);
+
+    StreamResult receiveDdp(const uint8_t* packet, size_t length);
+    StreamResult receiveE131(const uint8_t* packet, size_t length);
+
+    // The last complete frame, CHANNELS bytes
+    const uint8_t* frame() const { return front; }
+    // Forget sequence numbers, e.g. after a timeout
+    void reset();
+
+    uint16_t getFirstUniverse() const { return firstUniverse; }
+    uint32_t getPackets() const { return packets; }
+    uint32_t getFrames() const { return frames; }
+    uint32_t getLate() const { return late; }
+    uint32_t getInvalid() const { return invalid; }
+
+private:
+    uint8_t front[CHANNELS];
+    uint8_t pending[CHANNELS];
+    bool pendingData;
+    uint16_t firstUniverse;
+    uint8_t ddpSequence;                // 0 = none yet
+    int16_t e131Sequence[UNIVERSES];    // -1 = none yet
+    int32_t lastUniverse;               // -1 = none yet
+
+    uint32_t packets;
+    uint32_t frames;
+    uint32_t late;
+    uint32_t invalid;
+
+    void write(uint32_t offset, const uint8_t* data, size_t length);
+    bool publish();
+};
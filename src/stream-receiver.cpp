@@ -0,0 +1,96 @@
+#include "stream-receiver.h"
+#include <ESP8266WiFi.h>
+#include <lwip/igmp.h>
+
+StreamReceiver streamReceiver;
+
+StreamReceiver::StreamReceiver() : decoder(STREAM_UNIVERSE) {
+    lastPacketMs = 0;
+    streaming = false;
+    switched = false;
+    previousMode = ANIMATION_TEMPERATURE;
+}
+
+void StreamReceiver::begin() {
+    ddpSocket.begin(DDP_PORT);
+    e131Socket.begin(E131_PORT);
+    joinMulticast();
+
+    Serial.print("Stream receiver: DDP on port ");
+    Serial.print(DDP_PORT);
+    Serial.print(", E1.31 on port ");
+    Serial.print(E131_PORT);
+    Serial.print(" from universe ");
+    Serial.println(STREAM_UNIVERSE);
+}
+
+void StreamReceiver::joinMulticast() {
+    // E1.31 multicast goes to 239.255.<universe high>.<universe low>. Leaving first
+    // keeps lwIP's use count at one when the group did survive.
+    for (uint8_t u = 0; u < StreamDecoder::UNIVERSES; u++) {
+        uint16_t universe = STREAM_UNIVERSE + u;
+        ip4_addr_t group;
+        IP4_ADDR(&group, 239, 255, universe >> 8, universe & 0xFF);
+        igmp_leavegroup(IP4_ADDR_ANY4, &group);
+        if (igmp_joingroup(IP4_ADDR_ANY4, &group) != ERR_OK) {
+            Serial.print("Stream receiver: cannot join multicast for universe ");
+            Serial.println(universe);
+        }
+    }
+}
+
+void StreamReceiver::accept(StreamResult result) {
+    if (result == STREAM_END && streaming) {
+        stop("terminated by source");
+        return;
+    }
+    if (result != STREAM_DATA && result != STREAM_FRAME) {
+        return;
+    }
+    lastPacketMs = millis();
+    if (streaming) {
+        return;
+    }
+
+    streaming = true;
+    Serial.println("Stream started");
+    if (currentAnimation != ANIMATION_STREAM) {
+        previousMode = currentAnimation;
+        currentAnimation = ANIMATION_STREAM;
+        animationChanged = true;
+        switched = true;
+    }
+}
+
+void StreamReceiver::stop(const char* reason) {
+    streaming = false;
+    decoder.reset();
+    Serial.print("Stream ended: ");
+    Serial.println(reason);
+
+    if (switched && currentAnimation == ANIMATION_STREAM) {
+        currentAnimation = previousMode;
+        animationChanged = true;
+    }
+    switched = false;
+}
+
+void StreamReceiver::poll() {
+    // Drain what has arrived; only the newest complete frame ends up on screen
+    for (uint8_t n = 0; n < MAX_PACKETS_PER_POLL && ddpSocket.parsePacket() > 0; n++) {
+        int length = ddpSocket.read(packet, sizeof(packet));
+        if (length > 0) {
+            accept(decoder.receiveDdp(packet, length));
+        }
+    }
+    for (uint8_t n = 0; n < MAX_PACKETS_PER_POLL && e131Socket.parsePacket() > 0; n++) {
+        int length = e131Socket.read(packet, sizeof(packet));
+        if (length > 0) {
+            accept(decoder.receiveE131(packet, length));
+        }
+    }
+
+    if (streaming && millis() - lastPacketMs > STREAM_TIMEOUT_MS) {
+        stop("timeout");
+    }
+}
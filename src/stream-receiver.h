@@ -0,0 +1,60 @@
+// stream-receiver.h - UDP listener for realtime DDP and E1.31 frames
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include "stream-protocol.h"
+#include "webserver.h"
+
+// Without packets for this long the stream is over and the display returns to the
+// animation that played before it (build with -DSTREAM_TIMEOUT_MS=... to change)
+#ifndef STREAM_TIMEOUT_MS
+#define STREAM_TIMEOUT_MS 2500
+#endif
+
+// First E1.31 universe of the display (-DSTREAM_UNIVERSE=...); the 224 pixels take two
+#ifndef STREAM_UNIVERSE
+#define STREAM_UNIVERSE 1
+#endif
+
+// Listens for DDP on port 4048 and E1.31 on port 5568 (unicast, and multicast for
+// the display's universes). The first valid packet switches the display to
+// ANIMATION_STREAM, which shows frame(); when packets stop for STREAM_TIMEOUT_MS,
+// or an E1.31 source terminates its stream, the previous animation comes back.
+// Selecting another animation while a stream runs is respected until it ends.
+class StreamReceiver {
+public:
+    static const uint16_t DDP_PORT = 4048;
+    static const uint16_t E131_PORT = 5568;
+    // Whole DDP packet for the display, which also covers a full E1.31 packet
+    static const size_t PACKET_SIZE = 14 + StreamDecoder::CHANNELS;
+    // Packets read per poll and socket, so a flood cannot starve the other tasks
+    static const uint8_t MAX_PACKETS_PER_POLL = 8;
+
+    StreamReceiver();
+
+    void begin();
+    void poll();
+    // Join the multicast groups of the display's universes; again after every WiFi
+    // reconnect, since the groups do not survive the interface going down
+    void joinMulticast();
+
+    const uint8_t* frame() const { return decoder.frame(); }
+    bool isActive() const { return streaming; }
+    const StreamDecoder& getDecoder() const { return decoder; }
+
+private:
+    WiFiUDP ddpSocket;
+    WiFiUDP e131Socket;
+    StreamDecoder decoder;
+    uint8_t packet[PACKET_SIZE];
+    unsigned long lastPacketMs;
+    bool streaming;
+    bool switched;               // the receiver selected ANIMATION_STREAM itself
+    AnimationMode previousMode;
+
+    void accept(StreamResult result);
+    void stop(const char* reason);
+};
+
+extern StreamReceiver streamReceiver;
@@ -0,0 +1,133 @@
+#include "template-stream.h"
+
+static const uint32_t FNV_OFFSET = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+static uint32_t fnvAdd(uint32_t hash, const char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static bool isNameChar(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+TemplateStream::TemplateStream(const char* page, const TemplateVar* vars, uint8_t varCount)
+    : page(page), length(strlen_P(page)), vars(vars), varCount(varCount), pageHash(0) {
+}
+
+const TemplateVar* TemplateStream::find(const char* name, size_t nameLength) const {
+    for (uint8_t v = 0; v < varCount; v++) {
+        if (strlen(vars[v].name) == nameLength && strncmp(vars[v].name, name, nameLength) == 0) {
+            return &vars[v];
+        }
+    }
+    return nullptr;
+}
+
+String TemplateStream::etag() {
+    if (pageHash == 0) {
+        char block[BLOCK_SIZE];
+        uint32_t hash = FNV_OFFSET;
+        for (size_t pos = 0; pos < length; pos += BLOCK_SIZE) {
+            size_t n = length - pos < BLOCK_SIZE ? length - pos : BLOCK_SIZE;
+            memcpy_P(block, page + pos, n);
+            hash = fnvAdd(hash, block, n);
+        }
+        pageHash = hash ? hash : 1;
+    }
+
+    // Values are separated so "ab"+"c" and "a"+"bc" differ
+    uint32_t hash = pageHash;
+    for (uint8_t v = 0; v < varCount; v++) {
+        String value = vars[v].value();
+        hash = fnvAdd(hash, value.c_str(), value.length() + 1);
+    }
+
+    char tag[11];
+    snprintf(tag, sizeof(tag), "\"%08lx\"", (unsigned long)hash);
+    return String(tag);
+}
+
+void TemplateStream::send(AsyncWebServerRequest* request, const char* contentType) {
+    String tag = etag();
+    AsyncWebHeader* match = request->getHeader("If-None-Match");
+    if (match && match->value() == tag) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", tag);
+        request->send(response);
+        return;
+    }
+
+    // The filler outlives this call; the response owns the cursor through it
+    std::shared_ptr<Cursor> cursor(new Cursor());
+    AsyncWebServerResponse* response = request->beginChunkedResponse(contentType,
+        [this, cursor](uint8_t* buffer, size_t maxLength, size_t) {
+            return fill(*cursor, (char*)buffer, maxLength);
+        });
+    // no-cache still lets the browser keep the page; it just revalidates each visit
+    response->addHeader("ETag", tag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+size_t TemplateStream::fill(Cursor& cursor, char* buffer, size_t maxLength) const {
+    size_t written = 0;
+
+    while (written < maxLength) {
+        // Finish a placeholder value the last piece had no room for
+        if (cursor.valueOffset < cursor.value.length()) {
+            size_t n = cursor.value.length() - cursor.valueOffset;
+            if (n > maxLength - written) n = maxLength - written;
+            memcpy(buffer + written, cursor.value.c_str() + cursor.valueOffset, n);
+            cursor.valueOffset += n;
+            written += n;
+            continue;
+        }
+        if (cursor.pos >= length) {
+            break;
+        }
+
+        // Copy literal text straight into the response, up to the next '%'
+        size_t n = length - cursor.pos;
+        if (n > maxLength - written) n = maxLength - written;
+        memcpy_P(buffer + written, page + cursor.pos, n);
+        const char* percent = (const char*)memchr(buffer + written, '%', n);
+        if (!percent) {
+            written += n;
+            cursor.pos += n;
+            continue;
+        }
+        size_t literal = percent - (buffer + written);
+        if (literal > 0) {
+            written += literal;
+            cursor.pos += literal;
+            continue;
+        }
+
+        // At a '%': a known NAME% is replaced, anything else is sent as is
+        char name[MAX_NAME_LENGTH + 1];
+        size_t ahead = length - cursor.pos - 1;
+        if (ahead > sizeof(name)) ahead = sizeof(name);
+        memcpy_P(name, page + cursor.pos + 1, ahead);
+        size_t end = 0;
+        while (end < ahead && isNameChar(name[end])) {
+            end++;
+        }
+        const TemplateVar* var = nullptr;
+        if (end > 0 && end < ahead && name[end] == '%') {
+            var = find(name, end);
+        }
+        if (var) {
+            cursor.value = var->value();
+            cursor.valueOffset = 0;
+            cursor.pos += end + 2;
+        } else {
+            buffer[written++] = '%';
+            cursor.pos++;
+        }
+    }
+    return written;
+}
@@ -0,0 +1,53 @@
+// template-stream.h - Chunked streaming of a PROGMEM page with %NAME% substitution
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <memory>
+
+// A placeholder written %NAME% in the page and the function producing its text
+struct TemplateVar {
+    const char* name;
+    String (*value)();
+};
+
+// Serves a page held in flash without copying it into RAM. The server pulls the
+// response in pieces as the connection can take them (chunked transfer encoding);
+// each piece is read from flash and placeholders are replaced as they stream past. A '%' not followed by NAME% (CSS percentages) is sent as is.
+// The ETag covers the page and the current values, so a client revalidating with
+// If-None-Match gets a 304 without a body while neither has changed.
+class TemplateStream {
+public:
+    // Flash is hashed in blocks this size; handlers run on the small system stack
+    static const size_t BLOCK_SIZE = 128;
+    static const uint8_t MAX_NAME_LENGTH = 24;
+
+    TemplateStream(const char* page, const TemplateVar* vars, uint8_t varCount);
+
+    // Quoted entity tag of the page as it would render now
+    String etag();
+
+    // Answer the request: 304 if the client's copy is current, else the page
+    void send(AsyncWebServerRequest* request, const char* contentType);
+
+    // Bytes of the page template in flash
+    size_t size() const { return length; }
+
+private:
+    const char* page;  // PROGMEM
+    size_t length;
+    const TemplateVar* vars;
+    uint8_t varCount;
+    uint32_t pageHash;  // FNV-1a of the template, computed on first use
+
+    // Where one response is in the page, kept between calls of the filler
+    struct Cursor {
+        size_t pos = 0;          // next template byte
+        String value;            // placeholder text being written
+        size_t valueOffset = 0;  // bytes of value already written
+    };
+
+    const TemplateVar* find(const char* name, size_t nameLength) const;
+    // Write the next piece of the response; 0 once the page is complete
+    size_t fill(Cursor& cursor, char* buffer, size_t maxLength) const;
+};
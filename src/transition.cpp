@@ -0,0 +1,110 @@
+#include "transition.h"
+#include "animation.h"
+#include "matrix-geometry.h"
+
+Transition transition(DisplayGeometry::PIXELS);
+
+Transition::Transition(uint16_t numPixels) : from(numPixels) {
+    outgoing = nullptr;
+    style = TRANSITION_CROSSFADE;
+    durationMs = DEFAULT_DURATION_MS;
+    budgetUs = DEFAULT_BUDGET_US;
+    startMs = 0;
+    frozen = false;
+    lastCostUs = 0;
+    frozenCount = 0;
+}
+
+void Transition::start(Animation* animation) {
+    cancel();
+    if (style == TRANSITION_CUT || durationMs == 0) {
+        animation->end();
+        return;
+    }
+    outgoing = animation;
+    startMs = millis();
+    frozen = false;
+}
+
+void Transition::cancel() {
+    if (outgoing) {
+        outgoing->end();
+        outgoing = nullptr;
+    }
+}
+
+uint16_t Transition::progress() const {
+    // Wall time, like the playlist itself, so the speed setting does not stretch it
+    uint32_t elapsed = millis() - startMs;
+    return elapsed >= durationMs ? 256 : (uint16_t)((elapsed << 8) / durationMs);
+}
+
+void Transition::charge(uint32_t costUs) {
+    lastCostUs = costUs;
+    if (!frozen && costUs > budgetUs) {
+        frozen = true;
+        frozenCount++;
+        Serial.print("Transition over budget (");
+        Serial.print(costUs);
+        Serial.println(" us), freezing outgoing effect");
+    }
+}
+
+void Transition::update(uint32_t dtUs) {
+    if (!outgoing) {
+        return;
+    }
+    if (progress() >= 256) {
+        cancel();
+        return;
+    }
+    lastCostUs = 0;
+    if (!frozen) {
+        uint32_t start = micros();
+        outgoing->update(dtUs);
+        lastCostUs = micros() - start;
+    }
+}
+
+void Transition::render(Canvas& canvas) {
+    if (!outgoing) {
+        return;
+    }
+
+    uint32_t start = micros();
+    if (!frozen) {
+        outgoing->render(from);
+    }
+
+    uint16_t p = progress();
+    const Rgb16* old = from.getPixels();
+    if (style == TRANSITION_WIPE) {
+        // Columns left of the edge show the incoming effect; the edge column is mixed
+        uint32_t edge = (uint32_t)p * MATRIX_COLS;  // in 1/256 columns
+        for (uint16_t col = 0; col < MATRIX_COLS; col++) {
+            int32_t cover = (int32_t)edge - ((int32_t)col << 8);
+            if (cover >= 256) continue;
+            uint8_t alpha = cover > 0 ? cover : 0;
+            for (uint16_t row = 0; row < MATRIX_ROWS; row++) {
+                uint16_t i = DisplayGeometry::index(col, row);
+                canvas.setPixel(i, Canvas::blend(old[i], canvas.getPixel(i), BLEND_ALPHA, alpha));
+            }
+        }
+    } else {
+        uint8_t alpha = p > 255 ? 255 : p;
+        for (uint16_t i = 0; i < canvas.numPixels(); i++) {
+            canvas.setPixel(i, Canvas::blend(old[i], canvas.getPixel(i), BLEND_ALPHA, alpha));
+        }
+    }
+
+    // The outgoing update was timed in update(); budget the whole extra frame work
+    charge(lastCostUs + (micros() - start));
+}
+
+const char* Transition::styleName(TransitionStyle style) {
+    switch (style) {
+        case TRANSITION_CUT: return "cut";
+        case TRANSITION_WIPE: return "wipe";
+        default: return "crossfade";
+    }
+}
@@ -0,0 +1,67 @@
+// transition.h - Cross-fade and wipe between two effects using a second render target
+#pragma once
+
+#include <Arduino.h>
+#include "canvas.h"
+
+class Animation;
+
+enum TransitionStyle : uint8_t {
+    TRANSITION_CUT,        // switch instantly
+    TRANSITION_CROSSFADE,  // mix the two frames by alpha
+    TRANSITION_WIPE        // incoming effect sweeps in from the left
+};
+
+// Keeps the outgoing effect running for the transition window, renders it into its
+// own canvas and mixes that into the incoming effect's frame. The extra update and
+// render are timed every frame; once they go over budgetUs the outgoing effect is
+// frozen on its last frame for the rest of the window, so the double render never
+// costs the target frame rate.
+class Transition {
+public:
+    static const uint16_t DEFAULT_DURATION_MS = 1500;
+    static const uint32_t DEFAULT_BUDGET_US = 6000;
+
+    Transition(uint16_t numPixels);
+
+    void setStyle(TransitionStyle style) { this->style = style; }
+    TransitionStyle getStyle() const { return style; }
+    void setDuration(uint16_t ms) { durationMs = ms; }
+    uint16_t getDuration() const { return durationMs; }
+    void setBudget(uint32_t us) { budgetUs = us; }
+    uint32_t getBudget() const { return budgetUs; }
+
+    // Take over the outgoing effect (already begun) and mix it out over the window.
+    // With TRANSITION_CUT or no duration it is ended right away.
+    void start(Animation* outgoing);
+    // End the outgoing effect now
+    void cancel();
+    bool running() const { return outgoing != nullptr; }
+
+    // Advance the outgoing effect; ends it when the window is over
+    void update(uint32_t dtUs);
+    // Mix the outgoing frame into canvas, which holds the incoming effect's frame
+    void render(Canvas& canvas);
+
+    static const char* styleName(TransitionStyle style);
+
+    uint32_t getLastCostUs() const { return lastCostUs; }
+    unsigned long getFrozenCount() const { return frozenCount; }
+
+private:
+    Canvas from;
+    Animation* outgoing;
+    TransitionStyle style;
+    uint16_t durationMs;
+    uint32_t budgetUs;
+    unsigned long startMs;
+    bool frozen;
+    uint32_t lastCostUs;
+    unsigned long frozenCount;
+
+    // 0..256 through the window
+    uint16_t progress() const;
+    void charge(uint32_t costUs);
+};
+
+extern Transition transition;
@@ -0,0 +1,29 @@
+// trig-lut.h - Fixed-point sine lookup for animation kernels
+#pragma once
+
+#include <stdint.h>
+
+// Angles are 16-bit binary angles: 65536 units per full turn, so they wrap for free
+const uint16_t ANGLE16_HALF_TURN = 32768;
+constexpr float ANGLE16_PER_RADIAN = 10430.378f;  // 65536 / (2 * PI)
+
+extern const int16_t SINE_TABLE[257];
+
+// sin() in Q15 (-32767..32767), linearly interpolated between 256 table entries
+inline int16_t sin16(uint16_t angle)
+{
+    uint8_t i = angle >> 8;
+    int16_t a = SINE_TABLE[i];
+    int16_t b = SINE_TABLE[i + 1];
+    return a + (int16_t)(((int32_t)(b - a) * (angle & 0xFF)) >> 8);
+}
+
+inline int16_t cos16(uint16_t angle)
+{
+    return sin16(angle + 16384);
+}
+
+constexpr uint16_t radiansToAngle16(float radians)
+{
+    return (uint16_t)(int32_t)(radians * ANGLE16_PER_RADIAN);
+}
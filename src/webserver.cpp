@@ -1,8 +1,21 @@
 #include "webserver.h"
-#include "wifi-config-manager.h"
+#include "framebuffer.h"
+#include "frame-profiler.h"
+#include "scheduler.h"
+#include "animation.h"
+#include "power-limiter.h"
+#include "transition.h"
+#include "palette.h"
+#include "self-test.h"
+#include "marquee.h"
+#include "color-pipeline.h"
+#include "template-stream.h"
+#include "stream-receiver.h"
+#include "command-queue.h"
+#include "firmware-control.h"
 #include <ESP8266WiFi.h>
 
-ESP8266WebServer webServer(80);
+AsyncWebServer webServer(80);
 volatile AnimationMode currentAnimation = ANIMATION_AUTO;
 volatile bool animationChanged = false;
 
@@ -107,6 +120,12 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
         .animation-btn.temperature {
             background: linear-gradient(45deg, #FF5722, #D84315);
         }
+        .animation-btn.marquee {
+            background: linear-gradient(45deg, #009688, #00796B);
+        }
+        .animation-btn.stream {
+            background: linear-gradient(45deg, #3F51B5, #283593);
+        }
         .status {
             text-align: center;
             margin-top: 20px;
@@ -296,6 +315,14 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
                 Draw Mode
                 <br><small>Pixel-by-pixel drawing</small>
             </button>
+            <button class="animation-btn marquee" onclick="setAnimation(11, 'Marquee')">
+                Marquee
+                <br><small>Scrolling text message</small>
+            </button>
+            <button class="animation-btn stream" onclick="setAnimation(12, 'UDP Stream')">
+                UDP Stream
+                <br><small>DDP / E1.31 from xLights, LedFx</small>
+            </button>
         </div>
         
         <!-- Animation Speed Controls -->
@@ -312,6 +339,15 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
             </div>
         </div>
         
+        <!-- Brightness Control -->
+        <div class="speed-controls" style="margin-top: 20px; text-align: center; display: block;">
+            <h3 style="margin-bottom: 15px;">Brightness</h3>
+            <div style="margin-bottom: 15px;">
+                <input type="range" id="brightness-slider" min="0" max="255" step="1" value="255" onchange="changeBrightness(this.value)" style="width: 200px; margin: 0 10px;">
+                <span id="brightness-display" style="font-weight: bold; min-width: 50px; display: inline-block; text-align: center;">100%</span>
+            </div>
+        </div>
+        
         <!-- WiFi Settings Section -->
         <div class="wifi-settings" style="margin-top: 20px; text-align: center;">
             <h3 style="margin-bottom: 15px; color: #ff6b6b;">⚙️ WiFi Settings</h3>
@@ -359,6 +395,15 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
             </div>
         </div>
         
+        <!-- Marquee Section -->
+        <div class="color-section" id="marquee-section">
+            <h3 style="text-align: center; margin-bottom: 15px;">Marquee Text</h3>
+            <div class="color-picker-wrapper">
+                <input type="text" id="marquee-text" maxlength="160" placeholder="Message" style="padding: 8px; border-radius: 8px; border: none; width: 60%;">
+                <button class="draw-btn" onclick="setMarquee()">Show</button>
+            </div>
+        </div>
+        
         <div id="status" class="status"></div>
         
         <div class="device-info">
@@ -371,14 +416,7 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
         function setAnimation(mode, name) {
             const status = document.getElementById('status');
             
-            fetch('/setAnimation', {
-                method: 'POST',
-                headers: {
-                    'Content-Type': 'application/x-www-form-urlencoded',
-                },
-                body: 'animation=' + mode
-            })
-            .then(response => response.text())
+            sendControl([0x01, mode], 'Animation set to: ' + name)
             .then(data => {
                 document.getElementById('current').textContent = name;
                 status.textContent = 'Animation changed to: ' + name;
@@ -403,14 +441,9 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
             const speedValue = parseFloat(speed);
             document.getElementById('speed-display').textContent = speedValue.toFixed(1) + 'x';
             
-            fetch('/setSpeed', {
-                method: 'POST',
-                headers: {
-                    'Content-Type': 'application/x-www-form-urlencoded',
-                },
-                body: 'speed=' + speedValue
-            })
-            .then(response => response.text())
+            // 8.8 fixed point, as the device runs it
+            const fixed = Math.round(speedValue * 256);
+            sendControl([0x02, fixed & 0xFF, fixed >> 8], 'Animation speed set to: ' + speedValue.toFixed(1) + 'x')
             .then(data => {
                 const status = document.getElementById('status');
                 status.textContent = 'Animation speed updated to: ' + speedValue.toFixed(1) + 'x';
@@ -437,6 +470,31 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
             });
         }
         
+        function changeBrightness(value) {
+            const brightness = parseInt(value);
+            document.getElementById('brightness-display').textContent = Math.round(brightness * 100 / 255) + '%';
+            
+            sendControl([0x04, brightness], 'Brightness set to: ' + brightness)
+            .then(data => {
+                const status = document.getElementById('status');
+                status.textContent = data;
+                status.className = 'status success';
+                status.style.display = 'block';
+                setTimeout(() => {
+                    status.style.display = 'none';
+                }, 2000);
+            })
+            .catch(error => {
+                const status = document.getElementById('status');
+                status.textContent = 'Error updating brightness: ' + error.message;
+                status.className = 'status error';
+                status.style.display = 'block';
+                setTimeout(() => {
+                    status.style.display = 'none';
+                }, 5000);
+            });
+        }
+        
         function setSpeed(speed) {
             document.getElementById('speed-slider').value = speed;
             changeSpeed(speed);
@@ -482,9 +540,12 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
             const colorSection = document.getElementById('color-section');
             const drawingSection = document.getElementById('drawing-section');
             
+            const marqueeSection = document.getElementById('marquee-section');
+            
             // Hide all special sections first
             colorSection.style.display = 'none';
             drawingSection.style.display = 'none';
+            marqueeSection.style.display = 'none';
             
             if (mode === 9) { // ANIMATION_COLOR_PICKER mode
                 colorSection.style.display = 'block';
@@ -492,62 +553,118 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
                 colorSection.style.display = 'block';
                 drawingSection.style.display = 'block';
                 initializeDrawingGrid();
+            } else if (mode === 11) { // ANIMATION_MARQUEE
+                marqueeSection.style.display = 'block';
             }
         }
         
-        // Function to update temperature display
-        function updateTemperature() {
-            fetch('/getTemperature')
-                .then(response => response.json())
-                .then(data => {
-                    if (data.temperature !== -999.0) {
-                        document.getElementById('temperature').textContent = data.temperature.toFixed(1) + '°C';
-                    } else {
-                        document.getElementById('temperature').textContent = 'Error';
-                    }
-                    if (data.humidity !== -999.0) {
-                        document.getElementById('humidity').textContent = data.humidity.toFixed(1) + '%';
-                    } else {
-                        document.getElementById('humidity').textContent = 'Error';
-                    }
-                })
-                .catch(error => {
-                    console.log('Temperature fetch failed:', error);
-                    document.getElementById('temperature').textContent = 'N/A';
-                    document.getElementById('humidity').textContent = 'N/A';
-                });
+        // -999 means the sensor has no reading
+        function showSensor(temperature, humidity) {
+            if (temperature !== -999.0) {
+                document.getElementById('temperature').textContent = temperature.toFixed(1) + '°C';
+            } else {
+                document.getElementById('temperature').textContent = 'Error';
+            }
+            if (humidity !== -999.0) {
+                document.getElementById('humidity').textContent = humidity.toFixed(1) + '%';
+            } else {
+                document.getElementById('humidity').textContent = 'Error';
+            }
         }
         
-        setInterval(() => {
-            fetch('/getAnimation')
-                .then(response => response.json())
-                .then(data => {
-                    document.getElementById('current').textContent = data.name;
-                    updateNxControlsVisibility(data.mode);
-                })
-                .catch(error => console.log('Status refresh failed:', error));
-                
-            // Also update temperature
-            updateTemperature();
-        }, 5000);
+        // Live channel to the device on the same server as this page. Commands go
+        // over it, and the device pushes mode, settings and sensor readings on
+        // connect and whenever they change.
+        let socket = null;
+        
+        function connectSocket() {
+            socket = new WebSocket('ws://' + location.host + '/ws');
+            socket.binaryType = 'arraybuffer';
+            socket.onopen = () => scheduleFrame();
+            socket.onmessage = (event) => handleSocketMessage(new Uint8Array(event.data));
+            socket.onclose = () => {
+                socket = null;
+                setTimeout(connectSocket, 3000);
+            };
+        }
+        
+        function socketOpen() {
+            return socket !== null && socket.readyState === WebSocket.OPEN;
+        }
+        
+        // Resolves with sentText once the command is on its way
+        function sendControl(command, sentText) {
+            if (!socketOpen()) {
+                return Promise.reject(new Error('not connected to the device, reconnecting'));
+            }
+            socket.send(new Uint8Array(command));
+            return Promise.resolve(sentText);
+        }
+        
+        function handleSocketMessage(data) {
+            const view = new DataView(data.buffer);
+            if (data[0] === 0x81 && data.length >= 8) {
+                // State: mode, speed (8.8), brightness, R, G, B, name
+                document.getElementById('current').textContent = new TextDecoder().decode(data.subarray(8));
+                updateNxControlsVisibility(data[1]);
+                const speed = view.getUint16(2, true) / 256;
+                document.getElementById('speed-slider').value = speed;
+                document.getElementById('speed-display').textContent = speed.toFixed(2) + 'x';
+                document.getElementById('brightness-slider').value = data[4];
+                document.getElementById('brightness-display').textContent = Math.round(data[4] * 100 / 255) + '%';
+                const rgb = (data[5] << 16) | (data[6] << 8) | data[7];
+                document.getElementById('color-picker').value = '#' + rgb.toString(16).padStart(6, '0');
+            } else if (data[0] === 0x82 && data.length >= 5) {
+                // Sensor: temperature and humidity in tenths, -9990 if unknown
+                const temperature = view.getInt16(1, true);
+                const humidity = view.getInt16(3, true);
+                showSensor(temperature === -9990 ? -999.0 : temperature / 10,
+                           humidity === -9990 ? -999.0 : humidity / 10);
+            } else if (data[0] === 0x83) {
+                console.log('Command rejected by device:', data[1]);
+            }
+        }
         
-        // Initial temperature update
-        updateTemperature();
+        connectSocket();
         
         // Color picker functions
         function setColor(color) {
             const status = document.getElementById('status');
             
-            fetch('/setColor', {
+            const rgb = parseInt(color.substring(1), 16);
+            sendControl([0x03, rgb >> 16, (rgb >> 8) & 0xFF, rgb & 0xFF], 'Color set to: ' + color)
+            .then(data => {
+                status.textContent = 'Color updated to: ' + color;
+                status.className = 'status success';
+                status.style.display = 'block';
+                setTimeout(() => {
+                    status.style.display = 'none';
+                }, 2000);
+            })
+            .catch(error => {
+                status.textContent = 'Error updating color: ' + error.message;
+                status.className = 'status error';
+                status.style.display = 'block';
+                setTimeout(() => {
+                    status.style.display = 'none';
+                }, 5000);
+            });
+        }
+        
+        function setMarquee() {
+            const status = document.getElementById('status');
+            const text = document.getElementById('marquee-text').value;
+            
+            fetch('/setMarquee', {
                 method: 'POST',
                 headers: {
                     'Content-Type': 'application/x-www-form-urlencoded',
                 },
-                body: 'color=' + encodeURIComponent(color)
+                body: 'text=' + encodeURIComponent(text)
             })
             .then(response => response.text())
             .then(data => {
-                status.textContent = 'Color updated to: ' + color;
+                status.textContent = data;
                 status.className = 'status success';
                 status.style.display = 'block';
                 setTimeout(() => {
@@ -555,7 +672,7 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
                 }, 2000);
             })
             .catch(error => {
-                status.textContent = 'Error updating color: ' + error.message;
+                status.textContent = 'Error updating marquee: ' + error.message;
                 status.className = 'status error';
                 status.style.display = 'block';
                 setTimeout(() => {
@@ -635,19 +752,92 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
                 pixel.style.background = 'rgba(255, 255, 255, 0.1)';
             }
             
-            // Send update to server
-            updateDrawingPixel(col, row, drawingGridData[row][col]);
+            // Batched with the rest of the stroke
+            queueDrawingPixel(col, row);
         }
         
-        function updateDrawingPixel(col, row, state) {
-            fetch('/setPixel', {
-                method: 'POST',
-                headers: {
-                    'Content-Type': 'application/x-www-form-urlencoded',
-                },
-                body: `col=${col}&row=${row}&state=${state}`
-            })
-            .catch(error => console.log('Pixel update failed:', error));
+        // Pixels changed since the last frame message, sent at most once per display
+        // frame and never while the previous one is still queued in the socket
+        let dirtyPixels = new Set();
+        let frameScheduled = false;
+        
+        function queueDrawingPixel(col, row) {
+            dirtyPixels.add(row * 32 + col);
+            scheduleFrame();
+        }
+        
+        function scheduleFrame() {
+            if (!frameScheduled && dirtyPixels.size > 0) {
+                frameScheduled = true;
+                requestAnimationFrame(sendFrame);
+            }
+        }
+        
+        function pixelColor(index) {
+            const row = Math.floor(index / 32);
+            const col = index % 32;
+            return drawingGridData[row][col] ? parseInt(drawingGridColors[row][col].substring(1), 16) : 0;
+        }
+        
+        // Type 2 body: runs of start (2 bytes), count, R, G, B. Falls back to the
+        // type 1 full grid when that is shorter.
+        function encodeFrame() {
+            const indices = Array.from(dirtyPixels).sort((a, b) => a - b);
+            dirtyPixels.clear();
+            
+            const runs = [];
+            for (const index of indices) {
+                const color = pixelColor(index);
+                const last = runs[runs.length - 1];
+                if (last && last.start + last.count === index && last.color === color && last.count < 255) {
+                    last.count++;
+                } else {
+                    runs.push({ start: index, count: 1, color: color });
+                }
+            }
+            
+            if (runs.length * 6 >= 224 * 3) {
+                const body = new Uint8Array(1 + 224 * 3);
+                body[0] = 1;
+                for (let index = 0; index < 224; index++) {
+                    const color = pixelColor(index);
+                    body[1 + index * 3] = color >> 16;
+                    body[2 + index * 3] = (color >> 8) & 0xFF;
+                    body[3 + index * 3] = color & 0xFF;
+                }
+                return body;
+            }
+            
+            const body = new Uint8Array(1 + runs.length * 6);
+            body[0] = 2;
+            runs.forEach((run, i) => {
+                const at = 1 + i * 6;
+                body[at] = run.start & 0xFF;
+                body[at + 1] = run.start >> 8;
+                body[at + 2] = run.count;
+                body[at + 3] = run.color >> 16;
+                body[at + 4] = (run.color >> 8) & 0xFF;
+                body[at + 5] = run.color & 0xFF;
+            });
+            return body;
+        }
+        
+        function sendFrame() {
+            frameScheduled = false;
+            // Kept until the socket is back; it schedules a frame when it opens
+            if (dirtyPixels.size === 0 || !socketOpen()) return;
+            
+            // Wait while the previous frame is still queued in the socket
+            if (socket.bufferedAmount > 0) {
+                frameScheduled = true;
+                requestAnimationFrame(sendFrame);
+                return;
+            }
+            const body = encodeFrame();
+            const message = new Uint8Array(1 + body.length);
+            message[0] = 0x05;
+            message.set(body, 1);
+            socket.send(message);
         }
         
         function clearGrid() {
@@ -703,126 +893,565 @@ const char HTML_PAGE[] PROGMEM = R"HTML(
 </html>
 )HTML";
 
+static String deviceIp() { return WiFi.localIP().toString(); }
+static String wifiSsid() { return WiFi.SSID(); }
+
+static const TemplateVar PAGE_VARS[] = {
+    { "DEVICE_IP", deviceIp },
+    { "WIFI_SSID", wifiSsid }
+};
+static TemplateStream controlPage(HTML_PAGE, PAGE_VARS, sizeof(PAGE_VARS) / sizeof(PAGE_VARS[0]));
+
+// Handlers run in the network stack's context, not the loop: they check a request,
+// queue the change as a control-protocol message and answer at once. The loop
+// applies the queue between frames (see command-queue.h).
+static void enqueue(AsyncWebServerRequest* request, const uint8_t* message, size_t length,
+                    int code, const char* contentType, const String& response) {
+    if (commandQueue.push(message, length)) {
+        request->send(code, contentType, response);
+    } else {
+        request->send(503, "text/plain", "Busy, try again");
+    }
+}
+
+static void enqueue(AsyncWebServerRequest* request, const uint8_t* message, size_t length, const String& response) {
+    enqueue(request, message, length, 200, "text/plain", response);
+}
+
+// "#RRGGBB" or "RRGGBB"; false if it is not six digits
+static bool parseColor(String text, uint32_t& color) {
+    if (text.startsWith("#")) text = text.substring(1);
+    if (text.length() != 6) {
+        return false;
+    }
+    color = strtol(text.c_str(), NULL, 16) & 0xFFFFFF;
+    return true;
+}
+
+// Characters as the marquee counts them: every byte but UTF-8 continuation bytes
+static size_t textLength(const String& text) {
+    size_t count = 0;
+    for (size_t i = 0; i < text.length(); i++) {
+        if (((uint8_t)text[i] & 0xC0) != 0x80) count++;
+    }
+    return count;
+}
+
+// POST /frame bodies are collected into an opcode-prefixed message as they arrive
+static void collectFrameBody(AsyncWebServerRequest* request, uint8_t* data, size_t length, size_t index, size_t total) {
+    if (index == 0) {
+        // Too big to be a frame; handleFrame answers 400
+        if (total + 1 > CommandQueue::MAX_MESSAGE) {
+            return;
+        }
+        uint8_t* message = (uint8_t*)malloc(total + 1);  // freed with the request
+        if (!message) {
+            return;
+        }
+        message[0] = CMD_FRAME;
+        request->_tempObject = message;
+    }
+    if (request->_tempObject && index + length <= total) {
+        memcpy((uint8_t*)request->_tempObject + 1 + index, data, length);
+    }
+}
+
+static void handleFrame(AsyncWebServerRequest* request) {
+    const uint8_t* message = (const uint8_t*)request->_tempObject;
+    size_t length = request->contentLength();
+    if (length == 0) {
+        request->send(400, "text/plain", "Missing frame body");
+    } else if (!message || !isValidDrawingFrame(message + 1, length)) {
+        request->send(400, "text/plain", "Invalid frame (type 1: 672 RGB bytes, type 2: runs of start, count, RGB)");
+    } else {
+        enqueue(request, message, length + 1, "Frame updated");
+    }
+}
+
+// Live control channel on the web server itself: pages connect to ws://<device>/ws and
+// exchange the binary messages of control-protocol.h over one persistent connection
+// instead of an HTTP request per action. Commands go through the same queue as the
+// HTTP handlers; the loop pushes state and sensor changes to every open page,
+// whichever side made them.
+static AsyncWebSocket controlSocket("/ws");
+static ControlState pushedState;
+static SensorReading pushedReading;
+
+static ControlState currentState() {
+    ControlState state;
+    state.mode = currentAnimation;
+    state.speed = (uint16_t)(animationSpeed * 256 + 0.5f);
+    state.brightness = colorPipeline.getBrightness();
+    state.color = selectedColor;
+    state.name = getAnimationName(currentAnimation);
+    return state;
+}
+
+static int16_t toTenths(float value) {
+    // -999 is what the sensor globals hold until the first good read
+    return value <= -999.0f ? ControlProtocol::UNKNOWN_READING : (int16_t)lroundf(value * 10);
+}
+
+static SensorReading currentReading() {
+    SensorReading reading;
+    reading.temperatureTenths = toTenths(currentTemperature);
+    reading.humidityTenths = toTenths(currentHumidity);
+    return reading;
+}
+
+static void sendState(AsyncWebSocketClient* client) {
+    uint8_t message[ControlProtocol::MAX_STATE_LENGTH];
+    client->binary(message, ControlProtocol::encodeState(currentState(), message));
+}
+
+static void sendSensor(AsyncWebSocketClient* client) {
+    uint8_t message[ControlProtocol::SENSOR_LENGTH];
+    client->binary(message, ControlProtocol::encodeSensor(currentReading(), message));
+}
+
+static void sendError(AsyncWebSocketClient* client, const uint8_t* command, size_t length) {
+    uint8_t message[ControlProtocol::ERROR_LENGTH];
+    client->binary(message, ControlProtocol::encodeError(command, length, message));
+}
+
+// Socket clients are not authenticated. Forgetting the network would lock every
+// client out until someone joins the setup access point, so that stays with the
+// web page, which asks for confirmation first.
+static bool allowedOverSocket(const uint8_t* command, size_t length) {
+    return length == 0 || command[0] != CMD_RESET_WIFI;
+}
+
+static void onSocketEvent(AsyncWebSocket*, AsyncWebSocketClient* client, AwsEventType type,
+                          void* arg, uint8_t* data, size_t length) {
+    switch (type) {
+        case WS_EVT_CONNECT:
+            Serial.print("WebSocket client connected: ");
+            Serial.println(client->id());
+            sendState(client);
+            sendSensor(client);
+            break;
+        case WS_EVT_DISCONNECT:
+            Serial.print("WebSocket client disconnected: ");
+            Serial.println(client->id());
+            break;
+        case WS_EVT_DATA: {
+            // A command is one whole binary frame; text and fragmented frames are not
+            // part of the protocol
+            AwsFrameInfo* info = (AwsFrameInfo*)arg;
+            if (info->opcode != WS_BINARY || !info->final || info->index != 0 || info->len != length) {
+                if (info->opcode == WS_BINARY) sendError(client, nullptr, 0);
+                break;
+            }
+            if (length == 1 && data[0] == CMD_GET_STATE) {
+                sendState(client);
+                sendSensor(client);
+            } else if (!allowedOverSocket(data, length) || !commandQueue.push(data, length, client->id())) {
+                sendError(client, data, length);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Refused when the loop applied it; the client that sent it gets an error
+static void commandRejected(uint32_t source, const uint8_t* message, size_t length) {
+    AsyncWebSocketClient* client = source ? controlSocket.client(source) : nullptr;
+    if (client && client->status() == WS_CONNECTED) {
+        sendError(client, message, length);
+    }
+}
+
+// Broadcast changes made by any client or HTTP endpoint
+static void pushChanges() {
+    ControlState state = currentState();
+    if (state != pushedState) {
+        pushedState = state;
+        uint8_t message[ControlProtocol::MAX_STATE_LENGTH];
+        controlSocket.binaryAll(message, ControlProtocol::encodeState(state, message));
+    }
+    SensorReading reading = currentReading();
+    if (reading != pushedReading) {
+        pushedReading = reading;
+        uint8_t message[ControlProtocol::SENSOR_LENGTH];
+        controlSocket.binaryAll(message, ControlProtocol::encodeSensor(reading, message));
+    }
+}
+
 void initWebServer() {
-    webServer.on("/", handleRoot);
+    controlSocket.onEvent(onSocketEvent);
+    webServer.addHandler(&controlSocket);
+    pushedState = currentState();
+    pushedReading = currentReading();
+
+    webServer.on("/", HTTP_GET, handleRoot);
     webServer.on("/setAnimation", HTTP_POST, handleSetAnimation);
     
-    webServer.on("/setSpeed", HTTP_POST, []() {
-        if (webServer.hasArg("speed")) {
-            float newSpeed = webServer.arg("speed").toFloat();
+    webServer.on("/setSpeed", HTTP_POST, [](AsyncWebServerRequest* request) {
+        if (request->hasArg("speed")) {
+            float newSpeed = request->arg("speed").toFloat();
             
             if (newSpeed >= 0.2 && newSpeed <= 3.0) {
-                animationSpeed = newSpeed;
-                
-                String response = "Animation speed set to: " + String(newSpeed, 1) + "x";
-                webServer.send(200, "text/plain", response);
+                // The 8.8 fixed point the frame clock runs at
+                uint16_t speed = (uint16_t)(newSpeed * 256 + 0.5f);
+                uint8_t message[] = { CMD_SET_SPEED, (uint8_t)(speed & 0xFF), (uint8_t)(speed >> 8) };
+                enqueue(request, message, sizeof(message), "Animation speed set to: " + String(speed / 256.0f, 2) + "x");
+            } else {
+                request->send(400, "text/plain", "Invalid speed value (must be 0.2-3.0)");
+            }
+        } else {
+            request->send(400, "text/plain", "Missing speed parameter");
+        }
+    });
+    
+    // Master brightness, applied in the output pipeline without touching the frame
+    webServer.on("/setBrightness", HTTP_POST, [](AsyncWebServerRequest* request) {
+        if (request->hasArg("brightness")) {
+            int newBrightness = request->arg("brightness").toInt();
+            
+            if (newBrightness >= 0 && newBrightness <= 255) {
+                uint8_t message[] = { CMD_SET_BRIGHTNESS, (uint8_t)newBrightness };
+                enqueue(request, message, sizeof(message), "Brightness set to: " + String(newBrightness));
+            } else {
+                request->send(400, "text/plain", "Invalid brightness value (must be 0-255)");
+            }
+        } else {
+            request->send(400, "text/plain", "Missing brightness parameter");
+        }
+    });
+    
+    // Supply current budget for the power limiter
+    webServer.on("/setPowerLimit", HTTP_POST, [](AsyncWebServerRequest* request) {
+        if (request->hasArg("mA")) {
+            long newLimit = request->arg("mA").toInt();
+            
+            if (newLimit >= PowerLimiter::MIN_LIMIT_MA && newLimit <= PowerLimiter::MAX_LIMIT_MA) {
+                uint8_t message[] = { CMD_SET_POWER_LIMIT, (uint8_t)newLimit, (uint8_t)(newLimit >> 8) };
+                enqueue(request, message, sizeof(message), "Power limit set to: " + String(newLimit) + " mA");
+            } else {
+                request->send(400, "text/plain", "Invalid power limit (must be 500-15000 mA)");
+            }
+        } else {
+            request->send(400, "text/plain", "Missing mA parameter");
+        }
+    });
+    
+    // Auto Cycle hand-over between effects: style (cut, crossfade, wipe) and window
+    webServer.on("/setTransition", HTTP_POST, [](AsyncWebServerRequest* request) {
+        uint8_t style = ControlTarget::KEEP_STYLE;
+        TransitionStyle shownStyle = transition.getStyle();
+        if (request->hasArg("style")) {
+            String name = request->arg("style");
+            if (name == "cut") shownStyle = TRANSITION_CUT;
+            else if (name == "crossfade") shownStyle = TRANSITION_CROSSFADE;
+            else if (name == "wipe") shownStyle = TRANSITION_WIPE;
+            else {
+                request->send(400, "text/plain", "Invalid style (must be cut, crossfade or wipe)");
+                return;
+            }
+            style = shownStyle;
+        }
+        uint16_t duration = ControlTarget::KEEP_DURATION;
+        uint16_t shownDuration = transition.getDuration();
+        if (request->hasArg("ms")) {
+            long newDuration = request->arg("ms").toInt();
+            if (newDuration < 0 || newDuration > 5000) {
+                request->send(400, "text/plain", "Invalid duration (must be 0-5000 ms)");
+                return;
+            }
+            duration = shownDuration = newDuration;
+        }
+        
+        uint8_t message[] = { CMD_SET_TRANSITION, style, (uint8_t)duration, (uint8_t)(duration >> 8) };
+        enqueue(request, message, sizeof(message), "Transition set to: " + String(Transition::styleName(shownStyle)) +
+                ", " + String(shownDuration) + " ms");
+    });
+    
+    // Palette an effect colours with, by name (see PALETTE_NAMES in palette.cpp)
+    webServer.on("/setPalette", HTTP_POST, [](AsyncWebServerRequest* request) {
+        if (request->hasArg("animation") && request->hasArg("palette")) {
+            int mode = request->arg("animation").toInt();
+            PaletteId id = PaletteBank::find(request->arg("palette"));
+            
+            if (!AnimationRegistry::get(mode)) {
+                request->send(400, "text/plain", "Invalid animation mode");
+            } else if (id == PALETTE_COUNT) {
+                request->send(400, "text/plain", "Unknown palette");
+            } else {
+                uint8_t message[] = { CMD_SET_PALETTE, (uint8_t)mode, (uint8_t)id };
+                enqueue(request, message, sizeof(message),
+                        String(getAnimationName((AnimationMode)mode)) + " palette set to: " + PaletteBank::getName(id));
+            }
+        } else {
+            request->send(400, "text/plain", "Missing animation or palette parameter");
+        }
+    });
+    
+    // Custom palette from up to 16 stops, e.g. stops=0:000000,128:ff0000,255:ffff00
+    webServer.on("/uploadPalette", HTTP_POST, [](AsyncWebServerRequest* request) {
+        if (request->hasArg("stops")) {
+            String list = request->arg("stops");
+            // Opcode, then position, R, G, B per stop
+            uint8_t message[1 + 4 * Palette::MAX_STOPS] = { CMD_UPLOAD_PALETTE };
+            uint8_t count = 0;
+            long lastPosition = 0;
+            bool valid = true;
+            
+            int start = 0;
+            while (valid && start < (int)list.length()) {
+                int end = list.indexOf(',', start);
+                if (end < 0) end = list.length();
+                String stop = list.substring(start, end);
+                int colon = stop.indexOf(':');
+                long position = stop.substring(0, colon).toInt();
+                uint32_t color;
                 
-                Serial.print("Animation speed changed to: ");
-                Serial.println(newSpeed);
+                if (colon <= 0 || position < lastPosition || position > 255 ||
+                    !parseColor(stop.substring(colon + 1), color) || count == Palette::MAX_STOPS) {
+                    valid = false;
+                } else {
+                    uint8_t* entry = message + 1 + 4 * count;
+                    entry[0] = position;
+                    entry[1] = color >> 16;
+                    entry[2] = color >> 8;
+                    entry[3] = color;
+                    lastPosition = position;
+                    count++;
+                }
+                start = end + 1;
+            }
+            
+            if (valid && count > 0) {
+                enqueue(request, message, 1 + 4 * count, "Custom palette set from " + String(count) + " stops");
             } else {
-                webServer.send(400, "text/plain", "Invalid speed value (must be 0.2-3.0)");
+                request->send(400, "text/plain", "Invalid stops (1-16 of position:RRGGBB, positions 0-255 ascending)");
             }
         } else {
-            webServer.send(400, "text/plain", "Missing speed parameter");
+            request->send(400, "text/plain", "Missing stops parameter");
         }
     });
     
-    webServer.on("/getAnimation", HTTP_GET, []() {
+    webServer.on("/getPower", HTTP_GET, [](AsyncWebServerRequest* request) {
+        String response = "{\"mA\":" + String(powerLimiter.getEstimatedMa()) +
+                         ",\"requestedMa\":" + String(powerLimiter.getRequestedMa()) +
+                         ",\"limitMa\":" + String(powerLimiter.getLimit()) +
+                         ",\"limitedFrames\":" + String(powerLimiter.getLimitedFrames()) +
+                         ",\"wh\":" + String(powerLimiter.getWattHours(), 4) + "}";
+        request->send(200, "application/json", response);
+    });
+    
+    webServer.on("/getAnimation", HTTP_GET, [](AsyncWebServerRequest* request) {
         String response = "{\"mode\":" + String((int)currentAnimation) + 
                          ",\"name\":\"" + getAnimationName(currentAnimation) + 
                          "\"}";
-        webServer.send(200, "application/json", response);
+        request->send(200, "application/json", response);
     });
     
     // Temperature endpoint
-    webServer.on("/getTemperature", HTTP_GET, []() {
+    webServer.on("/getTemperature", HTTP_GET, [](AsyncWebServerRequest* request) {
         String response = "{\"temperature\":" + String(currentTemperature, 1) + 
                          ",\"humidity\":" + String(currentHumidity, 1) + 
                          "}";
-        webServer.send(200, "application/json", response);
+        request->send(200, "application/json", response);
     });
     
-    // Color picker endpoint
-    webServer.on("/setColor", HTTP_POST, []() {
-        if (webServer.hasArg("color")) {
-            String colorStr = webServer.arg("color");
-            
-            // Parse hex color string
-            if (colorStr.startsWith("#")) {
-                colorStr = colorStr.substring(1);
+    // Render profiling endpoint: cycles per frame for every animation and the output stage
+    webServer.on("/getStats", HTTP_GET, [](AsyncWebServerRequest* request) {
+        String response = "{\"cpuMHz\":" + String(ESP.getCpuFreqMHz()) + ",\"animations\":[";
+        for (int mode = 0; mode < ANIMATION_MODE_COUNT; mode++) {
+            const FrameStats& stats = frameProfiler.getStats((AnimationMode)mode);
+            if (mode > 0) response += ",";
+            response += "{\"name\":\"" + String(getAnimationName((AnimationMode)mode)) +
+                        "\",\"frames\":" + String(stats.frames) +
+                        ",\"avgCycles\":" + String(stats.averageCycles()) +
+                        ",\"maxCycles\":" + String(stats.maxCycles) +
+                        ",\"avgUs\":" + String(FrameProfiler::cyclesToMicros(stats.averageCycles())) +
+                        ",\"stateBytes\":" + String(AnimationRegistry::get(mode)->stateBytes()) + "}";
+        }
+        const FrameStats& output = frameProfiler.getOutputStats();
+        response += "],\"output\":{\"frames\":" + String(output.frames) +
+                    ",\"avgCycles\":" + String(output.averageCycles()) +
+                    ",\"maxCycles\":" + String(output.maxCycles) +
+                    ",\"skipped\":" + String(frameBuffer.getFramesSkipped()) +
+                    ",\"refreshed\":" + String(frameBuffer.getFramesRefreshed()) + "},\"tasks\":[";
+        for (uint8_t i = 0; i < scheduler.getTaskCount(); i++) {
+            const SchedulerTask& task = scheduler.getTask(i);
+            if (i > 0) response += ",";
+            response += "{\"name\":\"" + String(task.name) +
+                        "\",\"periodUs\":" + String(task.periodUs) +
+                        ",\"budgetUs\":" + String(task.budgetUs) +
+                        ",\"runs\":" + String(task.runs) +
+                        ",\"avgUs\":" + String(task.averageUs()) +
+                        ",\"maxUs\":" + String(task.maxUs) +
+                        ",\"overruns\":" + String(task.overruns) + "}";
+        }
+        response += "],\"arena\":{\"size\":" + String(AnimationRegistry::arenaSize()) +
+                    ",\"used\":" + String(AnimationRegistry::arenaUsed()) +
+                    "},\"transition\":{\"style\":\"" + String(Transition::styleName(transition.getStyle())) +
+                    "\",\"durationMs\":" + String(transition.getDuration()) +
+                    ",\"budgetUs\":" + String(transition.getBudget()) +
+                    ",\"lastCostUs\":" + String(transition.getLastCostUs()) +
+                    ",\"frozen\":" + String(transition.getFrozenCount()) +
+                    "},\"stream\":{\"active\":" + String(streamReceiver.isActive() ? "true" : "false") +
+                    ",\"packets\":" + String(streamReceiver.getDecoder().getPackets()) +
+                    ",\"frames\":" + String(streamReceiver.getDecoder().getFrames()) +
+                    ",\"late\":" + String(streamReceiver.getDecoder().getLate()) +
+                    ",\"invalid\":" + String(streamReceiver.getDecoder().getInvalid()) +
+                    "},\"commands\":{\"queued\":" + String(commandQueue.getPushed()) +
+                    ",\"applied\":" + String(commandQueue.getApplied()) +
+                    ",\"rejected\":" + String(commandQueue.getRejected()) +
+                    ",\"dropped\":" + String(commandQueue.getDropped()) +
+                    ",\"maxDepthBytes\":" + String(commandQueue.getMaxDepth()) +
+                    ",\"avgLatencyUs\":" + String(commandQueue.getAverageLatencyUs()) +
+                    ",\"maxLatencyUs\":" + String(commandQueue.getMaxLatencyUs()) +
+                    "},\"freeHeap\":" + String(ESP.getFreeHeap()) + "}";
+        request->send(200, "application/json", response);
+    });
+    
+    // Marquee message and how it scrolls; any of text, speed (columns/s), color, smooth
+    webServer.on("/setMarquee", HTTP_POST, [](AsyncWebServerRequest* request) {
+        if (!request->hasArg("text") && !request->hasArg("speed") &&
+            !request->hasArg("color") && !request->hasArg("smooth")) {
+            request->send(400, "text/plain", "Missing text, speed, color or smooth parameter");
+            return;
+        }
+        
+        uint8_t fields = 0;
+        long newSpeed = 0;
+        if (request->hasArg("speed")) {
+            newSpeed = request->arg("speed").toInt();
+            if (newSpeed < 1 || newSpeed > 60) {
+                request->send(400, "text/plain", "Invalid speed (must be 1-60 columns per second)");
+                return;
+            }
+            fields |= MARQUEE_SPEED;
+        }
+        uint32_t newColor = 0;
+        if (request->hasArg("color")) {
+            if (!parseColor(request->arg("color"), newColor)) {
+                request->send(400, "text/plain", "Invalid color format");
+                return;
+            }
+            fields |= MARQUEE_COLOR;
+        }
+        String text;
+        if (request->hasArg("text")) {
+            text = request->arg("text");
+            if (textLength(text) > Marquee::MAX_TEXT_LENGTH || text.length() > Marquee::MAX_TEXT_LENGTH * 4) {
+                request->send(400, "text/plain", "Text too long (max " + String(Marquee::MAX_TEXT_LENGTH) + " characters)");
+                return;
             }
+            fields |= MARQUEE_TEXT;
+        }
+        bool smooth = false;
+        if (request->hasArg("smooth")) {
+            smooth = request->arg("smooth").toInt() != 0;
+            fields |= MARQUEE_SMOOTH;
+        }
+        
+        // Up to four UTF-8 bytes per character; kept off the small system stack, and
+        // handlers never run concurrently
+        static uint8_t message[ControlProtocol::MARQUEE_HEADER + Marquee::MAX_TEXT_LENGTH * 4];
+        message[0] = CMD_SET_MARQUEE;
+        message[1] = fields;
+        message[2] = newSpeed;
+        message[3] = newColor >> 16;
+        message[4] = newColor >> 8;
+        message[5] = newColor;
+        message[6] = smooth;
+        memcpy(message + ControlProtocol::MARQUEE_HEADER, text.c_str(), text.length());
+        String response = "Marquee set to: " + (fields & MARQUEE_TEXT ? text : String(marquee.getText()));
+        enqueue(request, message, ControlProtocol::MARQUEE_HEADER + text.length(), response);
+    });
+    
+    // Golden-frame check of the effects; rebaseline=1 stores the current output as golden.
+    // It takes several frames, so it is queued; GET /selfTest returns the last report.
+    webServer.on("/selfTest", HTTP_POST, [](AsyncWebServerRequest* request) {
+        bool rebaseline = request->hasArg("rebaseline") && request->arg("rebaseline").toInt() == 1;
+        uint8_t message[] = { CMD_SELF_TEST, rebaseline };
+        enqueue(request, message, sizeof(message), 202, "text/plain", "Self test queued");
+    });
+    
+    webServer.on("/selfTest", HTTP_GET, [](AsyncWebServerRequest* request) {
+        const String& report = SelfTest::getLastReport();
+        if (SelfTest::isRunning()) {
+            request->send(202, "text/plain", "Self test running");
+        } else if (report.length() == 0) {
+            request->send(404, "text/plain", "No self test has run");
+        } else {
+            request->send(200, "application/json", report);
+        }
+    });
+    
+    webServer.on("/resetStats", HTTP_POST, [](AsyncWebServerRequest* request) {
+        uint8_t message[] = { CMD_RESET_STATS };
+        enqueue(request, message, sizeof(message), "Stats reset");
+    });
+    
+    // Color picker endpoint
+    webServer.on("/setColor", HTTP_POST, [](AsyncWebServerRequest* request) {
+        if (request->hasArg("color")) {
+            String colorStr = request->arg("color");
+            uint32_t color;
             
-            if (colorStr.length() == 6) {
-                long colorValue = strtol(colorStr.c_str(), NULL, 16);
+            if (parseColor(colorStr, color)) {
                 // Keep RGB format - NeoPixel library will handle BGR conversion
-                uint8_t r = (colorValue >> 16) & 0xFF;
-                uint8_t g = (colorValue >> 8) & 0xFF;
-                uint8_t b = colorValue & 0xFF;
-                selectedColor = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
-                
-                String response = "Color set to: #" + colorStr;
-                webServer.send(200, "text/plain", response);
-                
-                Serial.print("Color changed to: #");
-                Serial.println(colorStr);
+                uint8_t message[] = { CMD_SET_COLOR, (uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color };
+                if (colorStr.startsWith("#")) colorStr = colorStr.substring(1);
+                enqueue(request, message, sizeof(message), "Color set to: #" + colorStr);
             } else {
-                webServer.send(400, "text/plain", "Invalid color format");
+                request->send(400, "text/plain", "Invalid color format");
             }
         } else {
-            webServer.send(400, "text/plain", "Missing color parameter");
+            request->send(400, "text/plain", "Missing color parameter");
         }
     });
     
     // Drawing pixel endpoint
-    webServer.on("/setPixel", HTTP_POST, []() {
-        if (webServer.hasArg("col") && webServer.hasArg("row") && webServer.hasArg("state")) {
-            int col = webServer.arg("col").toInt();
-            int row = webServer.arg("row").toInt();
-            bool state = webServer.arg("state") == "true";
+    webServer.on("/setPixel", HTTP_POST, [](AsyncWebServerRequest* request) {
+        if (request->hasArg("col") && request->hasArg("row") && request->hasArg("state")) {
+            int col = request->arg("col").toInt();
+            int row = request->arg("row").toInt();
+            bool state = request->arg("state") == "true";
             
-            setDrawingPixel(col, row, state);
-            webServer.send(200, "text/plain", "Pixel updated");
+            if (DisplayGeometry::inBounds(col, row)) {
+                uint8_t message[] = { CMD_SET_PIXEL, (uint8_t)col, (uint8_t)row, state };
+                enqueue(request, message, sizeof(message), "Pixel updated");
+            } else {
+                request->send(400, "text/plain", "Invalid pixel");
+            }
         } else {
-            webServer.send(400, "text/plain", "Missing parameters");
+            request->send(400, "text/plain", "Missing parameters");
         }
     });
     
+    // Drawing grid as one binary body; the page batches strokes into these
+    webServer.on("/frame", HTTP_POST, handleFrame, nullptr, collectFrameBody);
+    
     // Clear grid endpoint
-    webServer.on("/clearGrid", HTTP_POST, []() {
-        clearDrawingGrid();
-        webServer.send(200, "text/plain", "Grid cleared");
+    webServer.on("/clearGrid", HTTP_POST, [](AsyncWebServerRequest* request) {
+        uint8_t message[] = { CMD_CLEAR_GRID };
+        enqueue(request, message, sizeof(message), "Grid cleared");
     });
     
     // Fill grid endpoint
-    webServer.on("/fillGrid", HTTP_POST, []() {
-        for (int col = 0; col < 32; col++) {
-            for (int row = 0; row < 7; row++) {
-                drawingGrid[col][row] = selectedColor;  // Use current selected color
-            }
-        }
-        needsGridUpdate = true;
-        webServer.send(200, "text/plain", "Grid filled");
+    webServer.on("/fillGrid", HTTP_POST, [](AsyncWebServerRequest* request) {
+        uint8_t message[] = { CMD_FILL_GRID };
+        enqueue(request, message, sizeof(message), "Grid filled");
     });
     
     // Draw border endpoint
-    webServer.on("/drawBorder", HTTP_POST, []() {
-        clearDrawingGrid();
-        for (int col = 0; col < 32; col++) {
-            for (int row = 0; row < 7; row++) {
-                if (row == 0 || row == 6 || col == 0 || col == 31) {
-                    drawingGrid[col][row] = selectedColor;  // Use current selected color
-                }
-            }
-        }
-        needsGridUpdate = true;
-        webServer.send(200, "text/plain", "Border drawn");
+    webServer.on("/drawBorder", HTTP_POST, [](AsyncWebServerRequest* request) {
+        uint8_t message[] = { CMD_DRAW_BORDER };
+        enqueue(request, message, sizeof(message), "Border drawn");
     });
     
-    // WiFi reset endpoint
-    webServer.on("/resetWiFi", HTTP_POST, []() {
-        webServer.send(200, "text/plain", "WiFi configuration reset. Device will restart...");
-        delay(1000);
-        wifiConfigManager.resetConfig();
+    // WiFi reset endpoint; the restart waits a second so this answer gets out. Only
+    // offered here: the WebSocket channel refuses the command.
+    webServer.on("/resetWiFi", HTTP_POST, [](AsyncWebServerRequest* request) {
+        uint8_t message[] = { CMD_RESET_WIFI };
+        enqueue(request, message, sizeof(message), "WiFi configuration reset. Device will restart...");
     });
     
     webServer.onNotFound(handleNotFound);
@@ -834,72 +1463,35 @@ void initWebServer() {
     Serial.println(" to control animations");
 }
 
+// Apply what the handlers queued, a few commands per call so a burst of requests
+// cannot hold up a frame
 void handleWebServer() {
-    webServer.handleClient();
+    commandQueue.apply(firmwareControl, 8, commandRejected);
+    firmwareControl.poll();
+    pushChanges();
+    controlSocket.cleanupClients();
 }
 
-void handleRoot() {
-    Serial.println("handleRoot called");
-    
-    String html;
-    html.reserve(16384); // Pre-allocate more memory for the large HTML
-    
-    // Read HTML from PROGMEM using proper method
-    html = FPSTR(HTML_PAGE);
-    
-    Serial.print("HTML length: ");
-    Serial.println(html.length());
-    
-    if (html.length() == 0) {
-        Serial.println("ERROR: HTML_PAGE is empty!");
-        html = "<html><body><h1>Error: HTML content not loaded</h1></body></html>";
-    }
-    
-    html.replace("%DEVICE_IP%", WiFi.localIP().toString());
-    html.replace("%WIFI_SSID%", WiFi.SSID());
-    
-    Serial.println("Sending HTML response");
-    webServer.send(200, "text/html", html);
+void handleRoot(AsyncWebServerRequest* request) {
+    controlPage.send(request, "text/html");
 }
 
-void handleSetAnimation() {
-    if (webServer.hasArg("animation")) {
-        int newMode = webServer.arg("animation").toInt();
+void handleSetAnimation(AsyncWebServerRequest* request) {
+    if (request->hasArg("animation")) {
+        int newMode = request->arg("animation").toInt();
         
-        if (newMode >= 0 && newMode <= 10) {  // Updated to 0-10 range to include all animations
-            currentAnimation = (AnimationMode)newMode;
-            animationChanged = true;
-            
-            String response = "Animation set to: " + String(getAnimationName(currentAnimation));
-            webServer.send(200, "text/plain", response);
-            
-            Serial.print("Animation changed via web interface to: ");
-            Serial.println(getAnimationName(currentAnimation));
+        if (AnimationRegistry::get(newMode)) {
+            uint8_t message[] = { CMD_SET_MODE, (uint8_t)newMode };
+            enqueue(request, message, sizeof(message),
+                    "Animation set to: " + String(getAnimationName((AnimationMode)newMode)));
         } else {
-            webServer.send(400, "text/plain", "Invalid animation mode");
+            request->send(400, "text/plain", "Invalid animation mode");
         }
     } else {
-        webServer.send(400, "text/plain", "Missing animation parameter");
+        request->send(400, "text/plain", "Missing animation parameter");
     }
 }
 
-void handleNotFound() {
-    webServer.send(404, "text/plain", "Page not found");
+void handleNotFound(AsyncWebServerRequest* request) {
+    request->send(404, "text/plain", "Page not found");
 }
-
-const char* getAnimationName(AnimationMode mode) {
-    switch (mode) {
-        case ANIMATION_TEMPERATURE: return "Temperature";
-        case ANIMATION_QIX_LINES: return "Qix Lines";
-        case ANIMATION_STARFIELD: return "Starfield";
-        case ANIMATION_STAR_WARP: return "Star Warp";
-        case ANIMATION_NEBULA: return "Nebula Swirl";
-        case ANIMATION_RED: return "All Red (10%)";
-        case ANIMATION_AUTO: return "Auto Cycle";
-        case ANIMATION_MATRIX: return "Matrix Rain";
-        case ANIMATION_FIRE: return "Fire Effect";
-        case ANIMATION_COLOR_PICKER: return "Color Picker";
-        case ANIMATION_DRAW_MODE: return "Draw Mode";
-        default: return "Unknown";
-    }
-}
\ No newline at end of file
@@ -2,7 +2,8 @@
 #pragma once
 
 #include <Arduino.h>
-#include <ESP8266WebServer.h>
+#include <ESPAsyncWebServer.h>
+#include "matrix-geometry.h"
 
 // Animation modes
 enum AnimationMode {
@@ -16,31 +17,42 @@ enum AnimationMode {
     ANIMATION_MATRIX,           // Matrix rain effect
     ANIMATION_FIRE,             // Fire effect
     ANIMATION_COLOR_PICKER,     // Color picker mode - solid color display
-    ANIMATION_DRAW_MODE         // Drawing mode - pixel by pixel drawing
+    ANIMATION_DRAW_MODE,        // Drawing mode - pixel by pixel drawing
+    ANIMATION_MARQUEE,          // Scrolling text message
+    ANIMATION_STREAM,           // Realtime frames received over UDP (DDP, E1.31)
+    ANIMATION_MODE_COUNT        // Number of modes - keep last
 };
 
-extern ESP8266WebServer webServer;
+extern AsyncWebServer webServer;
 extern volatile AnimationMode currentAnimation;
 extern volatile bool animationChanged;
 extern float animationSpeed;
 
 // Color picker and drawing variables
 extern uint32_t selectedColor;
-extern uint32_t drawingGrid[32][7];  // 32x7 matrix for pixel colors (0 = off, >0 = color)
-extern bool needsGridUpdate;
+extern uint32_t drawingGrid[MATRIX_COLS][MATRIX_ROWS];  // 32x7 matrix for pixel colors (0 = off, >0 = color)
 
 // Temperature variables
 extern float currentTemperature;
 extern float currentHumidity;
+extern bool temperatureValid;
 
 void initWebServer();
 void handleWebServer();
-void handleRoot();
-void handleSetAnimation();
-void handleNotFound();
+void handleRoot(AsyncWebServerRequest* request);
+void handleSetAnimation(AsyncWebServerRequest* request);
+void handleNotFound(AsyncWebServerRequest* request);
 
 // Drawing functions
 void clearDrawingGrid();
 void setDrawingPixel(int col, int row, bool state);
 
+// Body types of POST /frame
+enum DrawingFrameType : uint8_t {
+    FRAME_FULL = 1,  // every pixel
+    FRAME_RUNS = 2   // runs of pixels set to one colour
+};
+bool isValidDrawingFrame(const uint8_t* data, size_t length);
+bool setDrawingFrame(const uint8_t* data, size_t length);
+
 const char* getAnimationName(AnimationMode mode);
\ No newline at end of file
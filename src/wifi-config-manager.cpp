@@ -1,20 +1,20 @@
 #include "wifi-config-manager.h"
+#include <ESP8266WebServer.h>
 #include "ota-handler.h"
 #include <ArduinoJson.h>
-#include <Adafruit_NeoPixel.h>
+#include "overlay.h"
+#include "framebuffer.h"
 
 // Global instance
 WiFiConfigManager wifiConfigManager;
 
-// External reference to LED strip for visual feedback
-extern Adafruit_NeoPixel myLedStrip;
-extern int pixelIndex(int col, int row);
-
 WiFiConfigManager::WiFiConfigManager() {
     configServer = nullptr;
     isAPMode = false;
     buttonPressStart = 0;
     buttonPressed = false;
+    connecting = false;
+    connectStartTime = 0;
     config.isValid = false;
     memset(config.ssid, 0, WIFI_SSID_MAX_LEN);
     memset(config.password, 0, WIFI_PASSWORD_MAX_LEN);
@@ -126,7 +126,7 @@ void WiFiConfigManager::resetConfig() {
     ESP.restart();
 }
 
-bool WiFiConfigManager::connectToWiFi() {
+bool WiFiConfigManager::beginConnect() {
     if (!config.isValid || strlen(config.ssid) == 0) {
         Serial.println("No valid WiFi configuration");
         return false;
@@ -138,85 +138,60 @@ bool WiFiConfigManager::connectToWiFi() {
     WiFi.mode(WIFI_STA);
     WiFi.begin(config.ssid, config.password);
     
-    // Visual feedback during connection
-    unsigned long startTime = millis();
-    const unsigned long timeout = 30000; // 30 seconds
-    unsigned long lastToggle = 0;
-    const unsigned long toggleInterval = 200;
-    bool ledState = false;
-    
-    while (WiFi.status() != WL_CONNECTED && millis() - startTime < timeout) {
-        // Pulse corner LEDs in blue while connecting
-        if (millis() - lastToggle >= toggleInterval) {
-            lastToggle = millis();
-            ledState = !ledState;
-            
-            uint8_t brightness = ledState ? 64 : 0;
-            myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(0, 0, brightness));
-            myLedStrip.setPixelColor(pixelIndex(31, 0), myLedStrip.Color(0, 0, brightness));
-            myLedStrip.setPixelColor(pixelIndex(0, 6), myLedStrip.Color(0, 0, brightness));
-            myLedStrip.setPixelColor(pixelIndex(31, 6), myLedStrip.Color(0, 0, brightness));
-            myLedStrip.show();
-        }
-        delay(100);
-    }
+    connectStartTime = millis();
+    connecting = true;
     
-    // Clear corner LEDs
-    myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(0, 0, 0));
-    myLedStrip.setPixelColor(pixelIndex(31, 0), myLedStrip.Color(0, 0, 0));
-    myLedStrip.setPixelColor(pixelIndex(0, 6), myLedStrip.Color(0, 0, 0));
-    myLedStrip.setPixelColor(pixelIndex(31, 6), myLedStrip.Color(0, 0, 0));
-    myLedStrip.show();
+    // Blinking blue corners while connecting
+    overlay.showCorners(OVERLAY_WIFI, 0x000040, OVERLAY_BLINK, 400, 0);
+    return true;
+}
+
+WiFiConnectState WiFiConfigManager::pollConnect() {
+    if (!connecting) {
+        return WIFI_CONNECT_IDLE;
+    }
     
     if (WiFi.status() == WL_CONNECTED) {
-        Serial.println();
+        connecting = false;
         Serial.print("WiFi connected! IP address: ");
         Serial.println(WiFi.localIP());
         
         // Initialize OTA after successful connection
         initOTA();
         
-        // Success animation: Green flash
-        for (int i = 0; i < 3; i++) {
-            myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(0, 127, 0));
-            myLedStrip.setPixelColor(pixelIndex(31, 0), myLedStrip.Color(0, 127, 0));
-            myLedStrip.setPixelColor(pixelIndex(0, 6), myLedStrip.Color(0, 127, 0));
-            myLedStrip.setPixelColor(pixelIndex(31, 6), myLedStrip.Color(0, 127, 0));
-            myLedStrip.show();
-            delay(200);
-            myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(0, 0, 0));
-            myLedStrip.setPixelColor(pixelIndex(31, 0), myLedStrip.Color(0, 0, 0));
-            myLedStrip.setPixelColor(pixelIndex(0, 6), myLedStrip.Color(0, 0, 0));
-            myLedStrip.setPixelColor(pixelIndex(31, 6), myLedStrip.Color(0, 0, 0));
-            myLedStrip.show();
-            delay(200);
-        }
-        return true;
-    } else {
-        Serial.println();
-        Serial.println("Failed to connect to WiFi");
-        
-        // Error animation: Red flash
-        for (int i = 0; i < 5; i++) {
-            myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(127, 0, 0));
-            myLedStrip.setPixelColor(pixelIndex(31, 0), myLedStrip.Color(127, 0, 0));
-            myLedStrip.setPixelColor(pixelIndex(0, 6), myLedStrip.Color(127, 0, 0));
-            myLedStrip.setPixelColor(pixelIndex(31, 6), myLedStrip.Color(127, 0, 0));
-            myLedStrip.show();
-            delay(150);
-            myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(0, 0, 0));
-            myLedStrip.setPixelColor(pixelIndex(31, 0), myLedStrip.Color(0, 0, 0));
-            myLedStrip.setPixelColor(pixelIndex(0, 6), myLedStrip.Color(0, 0, 0));
-            myLedStrip.setPixelColor(pixelIndex(31, 6), myLedStrip.Color(0, 0, 0));
-            myLedStrip.show();
-            delay(150);
-        }
-        
-        // Mark config as invalid and clear it
-        config.isValid = false;
-        saveConfig();
+        // Success: green flash 3 times
+        overlay.showCorners(OVERLAY_WIFI, 0x007F00, OVERLAY_BLINK, 400, 1200);
+        return WIFI_CONNECT_OK;
+    }
+    
+    if (millis() - connectStartTime < CONNECT_TIMEOUT) {
+        return WIFI_CONNECT_PENDING;
+    }
+    
+    connecting = false;
+    Serial.println("Failed to connect to WiFi");
+    
+    // Error: red flash 5 times
+    overlay.showCorners(OVERLAY_WIFI, 0x7F0000, OVERLAY_BLINK, 300, 1500);
+    
+    // Mark config as invalid and clear it
+    config.isValid = false;
+    saveConfig();
+    return WIFI_CONNECT_FAILED;
+}
+
+bool WiFiConfigManager::connectToWiFi() {
+    if (!beginConnect()) {
         return false;
     }
+    
+    // Blocking wait for boot; keep frames (and the indicator) going out meanwhile
+    WiFiConnectState state;
+    while ((state = pollConnect()) == WIFI_CONNECT_PENDING) {
+        frameBuffer.update();
+        delay(10);
+    }
+    return state == WIFI_CONNECT_OK;
 }
 
 void WiFiConfigManager::startConfigMode() {
@@ -244,12 +219,8 @@ void WiFiConfigManager::startConfigMode() {
     // Start configuration web server
     startConfigServer();
     
-    // Visual feedback: Purple corners to indicate config mode
-    myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(64, 0, 64));
-    myLedStrip.setPixelColor(pixelIndex(31, 0), myLedStrip.Color(64, 0, 64));
-    myLedStrip.setPixelColor(pixelIndex(0, 6), myLedStrip.Color(64, 0, 64));
-    myLedStrip.setPixelColor(pixelIndex(31, 6), myLedStrip.Color(64, 0, 64));
-    myLedStrip.show();
+    // Visual feedback: Purple corners pulsing for as long as config mode lasts
+    overlay.showCorners(OVERLAY_WIFI, 0x400040, OVERLAY_PULSE, 5000, 0);
 }
 
 void WiFiConfigManager::startConfigServer() {
@@ -280,11 +251,7 @@ void WiFiConfigManager::stopConfigServer() {
     isAPMode = false;
     
     // Clear config mode visual feedback
-    myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(0, 0, 0));
-    myLedStrip.setPixelColor(pixelIndex(31, 0), myLedStrip.Color(0, 0, 0));
-    myLedStrip.setPixelColor(pixelIndex(0, 6), myLedStrip.Color(0, 0, 0));
-    myLedStrip.setPixelColor(pixelIndex(31, 6), myLedStrip.Color(0, 0, 0));
-    myLedStrip.show();
+    overlay.remove(OVERLAY_WIFI);
 }
 
 void WiFiConfigManager::handleClient() {
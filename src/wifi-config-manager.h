@@ -2,10 +2,12 @@
 
 #include <Arduino.h>
 #include <ESP8266WiFi.h>
-#include <ESP8266WebServer.h>
 #include <DNSServer.h>
 #include <LittleFS.h>
 
+// Included by the .cpp only: its HTTP method names clash with the async server's
+class ESP8266WebServer;
+
 // Maximum lengths for WiFi credentials
 #define WIFI_SSID_MAX_LEN 64
 #define WIFI_PASSWORD_MAX_LEN 64
@@ -14,6 +16,14 @@
 #define AP_PASSWORD "setup123"
 #define CAPTIVE_PORTAL_IP IPAddress(192, 168, 4, 1)
 
+// Progress of a non-blocking connection attempt
+enum WiFiConnectState {
+    WIFI_CONNECT_IDLE,
+    WIFI_CONNECT_PENDING,
+    WIFI_CONNECT_OK,
+    WIFI_CONNECT_FAILED
+};
+
 // WiFi configuration structure
 struct WiFiConfig {
     char ssid[WIFI_SSID_MAX_LEN];
@@ -30,6 +40,9 @@ private:
     unsigned long buttonPressStart;
     bool buttonPressed;
     static const unsigned long BUTTON_HOLD_TIME = 3000; // 3 seconds to trigger reset
+    bool connecting;
+    unsigned long connectStartTime;
+    static const unsigned long CONNECT_TIMEOUT = 30000; // 30 seconds
     
     void startConfigServer();
     void stopConfigServer();
@@ -41,7 +54,6 @@ private:
     void handleStatus();
     bool saveConfig();
     bool loadConfig();
-    void clearConfig();
     
 public:
     WiFiConfigManager();
@@ -51,13 +63,16 @@ public:
     bool begin();
     void handleClient();
     void checkResetButton(int buttonPin);
-    bool connectToWiFi();
+    bool connectToWiFi();  // blocks until connected or timed out (boot only)
+    bool beginConnect();   // start connecting; progress via pollConnect()
+    WiFiConnectState pollConnect();
     void startConfigMode();
     bool isConfigMode() { return isAPMode; }
     bool hasValidConfig() { return config.isValid; }
     const char* getSSID() { return config.ssid; }
     const char* getPassword() { return config.password; }
-    void resetConfig();
+    void clearConfig();    // forget the saved network; takes effect on the next restart
+    void resetConfig();    // clear, then restart into configuration mode
 };
 
 extern WiFiConfigManager wifiConfigManager;
\ No newline at end of file
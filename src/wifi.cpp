@@ -3,11 +3,9 @@
 #include "ota-handler.h"
 #include <ESP8266WiFi.h>
 #include <ESP8266mDNS.h>
-#include <Adafruit_NeoPixel.h>
-
-// External references from main.cpp
-extern Adafruit_NeoPixel myLedStrip;
-extern int pixelIndex(int col, int row);
+#include "overlay.h"
+#include "framebuffer.h"
+#include "stream-receiver.h"
 
 #define BUTTON_PIN 0  // Same as in main.cpp
 
@@ -46,31 +44,12 @@ void connectWifi()
     wifiConfigManager.startConfigMode();
     Serial.println("WiFi configuration mode started. Connect to 'NeoPixel-Setup' network to configure WiFi.");
     
-    // Show AP mode animation: purple corners pulsing
-    const int cols = 32;
-    const int rows = 7;
-    unsigned long lastPulse = 0;
-    int pulsePhase = 0;
-    
-    // Wait in configuration mode until WiFi is configured
+    // Wait in configuration mode until WiFi is configured; the pulsing purple
+    // corners are an overlay sprite, so only frame output needs servicing here
     while (wifiConfigManager.isConfigMode()) {
         wifiConfigManager.handleClient();
         handleOTA();
-        
-        // Pulsing purple corners animation to indicate config mode
-        if (millis() - lastPulse >= 50) {
-            lastPulse = millis();
-            pulsePhase = (pulsePhase + 1) % 100;
-            
-            uint8_t brightness = (uint8_t)(32 + 32 * sin(pulsePhase * 0.0628)); // 0.0628 ≈ 2π/100
-            
-            myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(brightness, 0, brightness));
-            myLedStrip.setPixelColor(pixelIndex(cols-1, 0), myLedStrip.Color(brightness, 0, brightness));
-            myLedStrip.setPixelColor(pixelIndex(0, rows-1), myLedStrip.Color(brightness, 0, brightness));
-            myLedStrip.setPixelColor(pixelIndex(cols-1, rows-1), myLedStrip.Color(brightness, 0, brightness));
-            myLedStrip.show();
-        }
-        
+        frameBuffer.update();
         delay(10);
     }
 }
@@ -80,25 +59,40 @@ bool isWiFiConnected() {
     return WiFi.status() == WL_CONNECTED;
 }
 
-// Handle WiFi reconnection if connection is lost
+// Handle WiFi reconnection if connection is lost. Called often; never blocks.
 void handleWiFiReconnection() {
     unsigned long currentTime = millis();
     
-    // Matrix dimensions
-    const int cols = 32;
-    const int rows = 7;
+    // Serve the captive portal on every call while in configuration mode
+    if (wifiConfigManager.isConfigMode()) {
+        wifiConfigManager.handleClient();
+        return;
+    }
     
-    // Only check WiFi status periodically to avoid excessive checking
-    if (currentTime - lastWiFiCheck < WIFI_CHECK_INTERVAL) {
+    // Follow a reconnection attempt in progress
+    WiFiConnectState state = wifiConfigManager.pollConnect();
+    if (state == WIFI_CONNECT_PENDING) {
+        return;
+    }
+    if (state == WIFI_CONNECT_OK) {
+        Serial.println("WiFi reconnected successfully!");
+        isReconnecting = false;
+        wasConnected = true;
+        streamReceiver.joinMulticast();
+        return;
+    }
+    if (state == WIFI_CONNECT_FAILED) {
+        Serial.println("Failed to reconnect. Starting configuration mode...");
+        isReconnecting = false;
+        wifiConfigManager.startConfigMode();
         return;
     }
-    lastWiFiCheck = currentTime;
     
-    // Handle configuration mode if active
-    if (wifiConfigManager.isConfigMode()) {
-        wifiConfigManager.handleClient();
+    // Only check WiFi status periodically to avoid excessive checking
+    if (currentTime - lastWiFiCheck < WIFI_CHECK_INTERVAL) {
         return;
     }
+    lastWiFiCheck = currentTime;
     
     bool currentlyConnected = isWiFiConnected();
     
@@ -109,47 +103,15 @@ void handleWiFiReconnection() {
         isReconnecting = true;
         
         // Brief visual indication of disconnection (red flash on corners)
-        myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(127, 0, 0));
-        myLedStrip.setPixelColor(pixelIndex(cols-1, 0), myLedStrip.Color(127, 0, 0));
-        myLedStrip.setPixelColor(pixelIndex(0, rows-1), myLedStrip.Color(127, 0, 0));
-        myLedStrip.setPixelColor(pixelIndex(cols-1, rows-1), myLedStrip.Color(127, 0, 0));
-        myLedStrip.show();
-        delay(100);
-        // Clear the corners after indication
-        myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(0, 0, 0));
-        myLedStrip.setPixelColor(pixelIndex(cols-1, 0), myLedStrip.Color(0, 0, 0));
-        myLedStrip.setPixelColor(pixelIndex(0, rows-1), myLedStrip.Color(0, 0, 0));
-        myLedStrip.setPixelColor(pixelIndex(cols-1, rows-1), myLedStrip.Color(0, 0, 0));
-        myLedStrip.show();
+        overlay.showCorners(OVERLAY_WIFI, 0x7F0000, OVERLAY_SOLID, 100, 100);
     }
     
-    // Handle reconnection after delay
+    // Start reconnecting after delay; pollConnect() above follows it from here
     if (isReconnecting && !currentlyConnected) {
         if (currentTime - disconnectTime >= RECONNECT_DELAY) {
             Serial.println("Attempting WiFi reconnection...");
-            
-            // Try to reconnect using the WiFi config manager
-            if (wifiConfigManager.connectToWiFi()) {
-                Serial.println("WiFi reconnected successfully!");
-                Serial.print("IP address: ");
-                Serial.println(WiFi.localIP());
-                isReconnecting = false;
-                initOTA(); // Reinitialize OTA after reconnection
-                
-                // Brief success indication (green flash on corners)
-                myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(0, 127, 0));
-                myLedStrip.setPixelColor(pixelIndex(cols-1, 0), myLedStrip.Color(0, 127, 0));
-                myLedStrip.setPixelColor(pixelIndex(0, rows-1), myLedStrip.Color(0, 127, 0));
-                myLedStrip.setPixelColor(pixelIndex(cols-1, rows-1), myLedStrip.Color(0, 127, 0));
-                myLedStrip.show();
-                delay(200);
-                myLedStrip.setPixelColor(pixelIndex(0, 0), myLedStrip.Color(0, 0, 0));
-                myLedStrip.setPixelColor(pixelIndex(cols-1, 0), myLedStrip.Color(0, 0, 0));
-                myLedStrip.setPixelColor(pixelIndex(0, rows-1), myLedStrip.Color(0, 0, 0));
-                myLedStrip.setPixelColor(pixelIndex(cols-1, rows-1), myLedStrip.Color(0, 0, 0));
-                myLedStrip.show();
-            } else {
-                Serial.println("Failed to reconnect. Starting configuration mode...");
+            if (!wifiConfigManager.beginConnect()) {
+                Serial.println("No saved network to reconnect to. Starting configuration mode...");
                 isReconnecting = false;
                 wifiConfigManager.startConfigMode();
             }
@@ -2,9 +2,6 @@
 #pragma once
 
 #include <Arduino.h>
-#include <Adafruit_NeoPixel.h>
-
-extern Adafruit_NeoPixel myLedStrip;
 
 void connectWifi();
 void handleWiFiReconnection();
@@ -0,0 +1,91 @@
+// ws2812-encoder.h - WS2812 bitstream encoding for the UART output backend
+#pragma once
+
+#include <stdint.h>
+
+// The UART runs at 3.2 Mbaud, 6N1, with TX inverted. One UART frame is then 8 bit
+// times of 312.5 ns: the (inverted) start bit is always high, the stop bit always
+// low, and the six data bits in between shape two WS2812 bits of four slots each:
+//   WS2812 "0" = high 1 slot, low 3 slots  (T0H 312 ns, T0L 938 ns)
+//   WS2812 "1" = high 3 slots, low 1 slot  (T1H 938 ns, T1L 312 ns)
+// Data bits go out LSB first and inverted, giving one table entry per bit pair.
+const uint32_t WS2812_UART_BAUD = 3200000;
+const uint8_t WS2812_UART_BYTES_PER_CHANNEL = 4;
+
+constexpr uint8_t WS2812_UART_PATTERNS[4] = {
+    0b110111,  // 00
+    0b000111,  // 01
+    0b110100,  // 10
+    0b000100   // 11
+};
+
+// Wire order of the three colour bytes, as shifts into a 0x00RRGGBB pixel
+struct Ws2812Order {
+    uint8_t first;
+    uint8_t second;
+    uint8_t third;
+};
+
+const Ws2812Order WS2812_ORDER_GRB = { 8, 16, 0 };
+const Ws2812Order WS2812_ORDER_BGR = { 0, 8, 16 };
+
+inline uint8_t* ws2812EncodeChannel(uint8_t value, uint8_t* out)
+{
+    out[0] = WS2812_UART_PATTERNS[(value >> 6) & 3];
+    out[1] = WS2812_UART_PATTERNS[(value >> 4) & 3];
+    out[2] = WS2812_UART_PATTERNS[(value >> 2) & 3];
+    out[3] = WS2812_UART_PATTERNS[value & 3];
+    return out + WS2812_UART_BYTES_PER_CHANNEL;
+}
+
+// Encodes count pixels into out, which must hold count * 12 bytes; returns bytes written
+inline uint32_t ws2812EncodeUart(const uint32_t* pixels, uint16_t count, Ws2812Order order, uint8_t* out)
+{
+    uint8_t* p = out;
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t c = pixels[i];
+        p = ws2812EncodeChannel((uint8_t)(c >> order.first), p);
+        p = ws2812EncodeChannel((uint8_t)(c >> order.second), p);
+        p = ws2812EncodeChannel((uint8_t)(c >> order.third), p);
+    }
+    return (uint32_t)(p - out);
+}
+
+// Line level of slot 0..7 of a UART frame carrying pattern, as the strip sees it
+constexpr bool ws2812UartLineHigh(uint8_t pattern, uint8_t slot)
+{
+    return slot == 0 ? true                                   // inverted start bit
+         : slot == 7 ? false                                  // inverted stop bit
+         : ((pattern >> (slot - 1)) & 1) == 0;                // inverted data bit
+}
+
+// Leading high slots of the WS2812 bit occupying slots [slot, slot + remaining)
+constexpr uint8_t ws2812UartHighSlots(uint8_t pattern, uint8_t slot, uint8_t remaining)
+{
+    return (remaining == 0 || !ws2812UartLineHigh(pattern, slot))
+        ? 0 : 1 + ws2812UartHighSlots(pattern, slot + 1, remaining - 1);
+}
+
+// All high slots anywhere in the bit; must equal the leading ones for a single clean pulse
+constexpr uint8_t ws2812UartTotalHighSlots(uint8_t pattern, uint8_t slot, uint8_t remaining)
+{
+    return remaining == 0 ? 0
+        : (ws2812UartLineHigh(pattern, slot) ? 1 : 0) + ws2812UartTotalHighSlots(pattern, slot + 1, remaining - 1);
+}
+
+// Every bit pair must produce one pulse per WS2812 bit inside the datasheet windows
+// (T0H 250-550 ns, T1H 650-950 ns, 312.5 ns per slot); checked at compile time
+constexpr bool ws2812UartPulseOk(uint8_t pair, uint8_t slot, bool bitSet)
+{
+    return ws2812UartHighSlots(WS2812_UART_PATTERNS[pair], slot, 4) ==
+               ws2812UartTotalHighSlots(WS2812_UART_PATTERNS[pair], slot, 4) &&
+           (bitSet ? (ws2812UartHighSlots(WS2812_UART_PATTERNS[pair], slot, 4) * 3125 / 10 >= 650 &&
+                      ws2812UartHighSlots(WS2812_UART_PATTERNS[pair], slot, 4) * 3125 / 10 <= 950)
+                   : (ws2812UartHighSlots(WS2812_UART_PATTERNS[pair], slot, 4) * 3125 / 10 >= 250 &&
+                      ws2812UartHighSlots(WS2812_UART_PATTERNS[pair], slot, 4) * 3125 / 10 <= 550));
+}
+
+static_assert(ws2812UartPulseOk(0, 0, false) && ws2812UartPulseOk(0, 4, false), "00 pattern out of spec");
+static_assert(ws2812UartPulseOk(1, 0, false) && ws2812UartPulseOk(1, 4, true), "01 pattern out of spec");
+static_assert(ws2812UartPulseOk(2, 0, true) && ws2812UartPulseOk(2, 4, false), "10 pattern out of spec");
+static_assert(ws2812UartPulseOk(3, 0, true) && ws2812UartPulseOk(3, 4, true), "11 pattern out of spec");
@@ -0,0 +1,43 @@
+// Render cost of every effect on the host: update and render per frame, and the
+// output stage (colour pipeline, overlay, power limiter) per frame sent.
+//   bench-effects [frames]
+// Times come from the same frame profiler as /getStats; on the host a "cycle" is a
+// nanosecond, so compare numbers between builds on one machine, not with the device.
+#include "host-firmware.h"
+#include "animation.h"
+#include "frame-profiler.h"
+#include "prng.h"
+
+int main(int argc, char** argv) {
+    const uint32_t FRAME_DT_US = 20000;
+    int frames = argc > 1 ? atoi(argv[1]) : 2000;
+
+    Prng::setBaseSeed(0x5EED1234);
+    temperatureValid = true;
+    currentTemperature = 23.4;
+    for (int col = 0; col < MATRIX_COLS; col++) {
+        for (int row = 0; row < MATRIX_ROWS; row++) {
+            drawingGrid[col][row] = (col + row) % 3 ? 0 : 0x3060C0;
+        }
+    }
+
+    printf("%-16s %10s %10s %10s %6s\n", "effect", "avg ns", "max ns", "out ns", "state");
+    for (int mode = 0; mode < ANIMATION_MODE_COUNT; mode++) {
+        // Auto Cycle's frames are counted under the effect it is showing
+        if (mode == ANIMATION_AUTO) continue;
+        frameProfiler.reset();
+        animationPlayer.select((AnimationMode)mode);
+        for (int i = 0; i < frames; i++) {
+            hostAdvanceMicros(FRAME_DT_US);
+            animationPlayer.frame(FRAME_DT_US);
+        }
+        animationPlayer.stop();
+
+        Animation* animation = AnimationRegistry::get(mode);
+        const FrameStats& stats = frameProfiler.getStats((AnimationMode)mode);
+        const FrameStats& output = frameProfiler.getOutputStats();
+        printf("%-16s %10u %10u %10u %6zu\n", animation->getName(), stats.averageCycles(), stats.maxCycles,
+               output.averageCycles(), animation->stateBytes());
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Cost of the Wu line rasteriser Qix draws with, against the Bresenham line it
+// replaced (kept here as it was), on the same set of random lines across the matrix.
+//   bench-lines [lines]
+// Both draw with BLEND_ADD as Qix does. Cycles are nanoseconds on the host, so
+// compare the two numbers with each other, not with the device.
+#include "host-firmware.h"
+#include "line.h"
+#include "matrix-geometry.h"
+#include "prng.h"
+
+#include <vector>
+
+// The integer-endpoint Bresenham drawLine Qix used before the Wu rasteriser
+static void drawLineBresenham(Canvas& canvas, float x1, float y1, float x2, float y2, uint32_t color, BlendMode mode) {
+    int ix1 = (int)x1;
+    int iy1 = (int)y1;
+    int ix2 = (int)x2;
+    int iy2 = (int)y2;
+
+    int dx = abs(ix2 - ix1);
+    int dy = abs(iy2 - iy1);
+    int sx = (ix1 < ix2) ? 1 : -1;
+    int sy = (iy1 < iy2) ? 1 : -1;
+    int err = dx - dy;
+
+    int x = ix1;
+    int y = iy1;
+
+    while (true) {
+        if (DisplayGeometry::inBounds(x, y)) {
+            canvas.blendPixel(DisplayGeometry::index(x, y), color, mode);
+        }
+
+        if (x == ix2 && y == iy2) break;
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+struct BenchLine {
+    float x1, y1, x2, y2;
+};
+
+typedef void (*LineFunction)(Canvas&, float, float, float, float, uint32_t, BlendMode);
+
+// Average cycles per line over every line, redrawn rounds times
+static uint32_t timeLines(LineFunction draw, const std::vector<BenchLine>& lines, int rounds) {
+    Canvas canvas(DisplayGeometry::PIXELS);
+    uint64_t total = 0;
+    for (int round = 0; round < rounds; round++) {
+        canvas.clear();
+        uint32_t start = ESP.getCycleCount();
+        for (const BenchLine& line : lines) {
+            draw(canvas, line.x1, line.y1, line.x2, line.y2, 0x006464, BLEND_ADD);
+        }
+        total += ESP.getCycleCount() - start;
+    }
+    return (uint32_t)(total / ((uint64_t)rounds * lines.size()));
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000;
+    const int ROUNDS = 200;
+
+    // Endpoints anywhere on the matrix, with sub-pixel positions like Qix's
+    Prng rng(0x5EED1234);
+    std::vector<BenchLine> lines(count);
+    for (BenchLine& line : lines) {
+        line.x1 = rng.below((MATRIX_COLS - 1) * 256) / 256.0f;
+        line.y1 = rng.below((MATRIX_ROWS - 1) * 256) / 256.0f;
+        line.x2 = rng.below((MATRIX_COLS - 1) * 256) / 256.0f;
+        line.y2 = rng.below((MATRIX_ROWS - 1) * 256) / 256.0f;
+    }
+
+    uint32_t bresenham = timeLines(drawLineBresenham, lines, ROUNDS);
+    uint32_t wu = timeLines(drawLine, lines, ROUNDS);
+    printf("%-12s %10s\n", "line", "avg ns");
+    printf("%-12s %10u\n", "Bresenham", bresenham);
+    printf("%-12s %10u\n", "Wu", wu);
+    return 0;
+}
@@ -0,0 +1,37 @@
+// Adafruit_NeoPixel.h - Host stand-in for the NeoPixel library: a pixel array and a show() counter
+#pragma once
+
+#include <Arduino.h>
+
+#define NEO_GRB 0x52
+#define NEO_BGR 0xA4
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t count, int16_t /* pin */ = 6, uint16_t /* type */ = NEO_GRB + NEO_KHZ800)
+        : count(count), pixels(new uint32_t[count]()), shows(0) {}
+    ~Adafruit_NeoPixel() { delete[] pixels; }
+
+    void begin() {}
+    void show() { shows++; }
+    bool canShow() const { return true; }
+    uint16_t numPixels() const { return count; }
+
+    void setPixelColor(uint16_t index, uint32_t color) {
+        if (index < count) pixels[index] = color;
+    }
+    uint32_t getPixelColor(uint16_t index) const { return index < count ? pixels[index] : 0; }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+    // Host only: frames sent so far
+    unsigned long getShows() const { return shows; }
+
+private:
+    uint16_t count;
+    uint32_t* pixels;
+    unsigned long shows;
+};
@@ -0,0 +1,85 @@
+#include "Arduino.h"
+#include <chrono>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static uint64_t simulatedUs = 0;
+
+unsigned long millis() {
+    return (unsigned long)(simulatedUs / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)simulatedUs;
+}
+
+void delay(unsigned long ms) {
+    simulatedUs += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+    simulatedUs += us;
+}
+
+void yield() {
+}
+
+void hostAdvanceMicros(uint32_t us) {
+    simulatedUs += us;
+}
+
+long random(long max) {
+    return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max) {
+    return max > min ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed) {
+    srand(seed);
+}
+
+uint32_t EspClass::getCycleCount() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+size_t HardwareSerial::write(const String& text) {
+    static const bool echo = getenv("NEOPIXEL_SERIAL") != nullptr;
+    if (echo) {
+        fputs(text.c_str(), stderr);
+    }
+    return text.length();
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t position = text.find(c, from);
+    return position == std::string::npos ? -1 : (int)position;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (to > text.length()) to = text.length();
+    if (from >= to) return String();
+    return String(text.substr(from, to - from));
+}
+
+std::string String::format(long value, unsigned char base) {
+    if (value < 0 && base == DEC) {
+        return "-" + format((unsigned long)-value, base);
+    }
+    return format((unsigned long)value, base);
+}
+
+std::string String::format(unsigned long value, unsigned char base) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), base == HEX ? "%lx" : "%lu", value);
+    return buffer;
+}
+
+std::string String::format(double value, unsigned char decimals) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    return buffer;
+}
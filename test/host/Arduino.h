@@ -0,0 +1,131 @@
+// Arduino.h - Host stand-in for the parts of the ESP8266 Arduino core the firmware uses
+#pragma once
+
+// Only what the effects, the output pipeline and the protocols need to build and
+// run on Linux. Time is simulated: millis() and micros() only move when delay() or
+// hostAdvanceMicros() is called, so tests and benchmarks replay exactly.
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+using std::min;
+using std::max;
+
+#define PI 3.1415926535897932384626433832795
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_dword(address) (*(const uint32_t*)(address))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strncmp_P strncmp
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+// Host only: move the simulated clock forward
+void hostAdvanceMicros(uint32_t us);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return HIGH; }
+
+class String {
+public:
+    String(const char* text = "") : text(text ? text : "") {}
+    String(const std::string& text) : text(text) {}
+    String(char c) : text(1, c) {}
+    String(int value, unsigned char base = DEC) : text(format((long)value, base)) {}
+    String(unsigned int value, unsigned char base = DEC) : text(format((unsigned long)value, base)) {}
+    String(long value, unsigned char base = DEC) : text(format(value, base)) {}
+    String(unsigned long value, unsigned char base = DEC) : text(format(value, base)) {}
+    String(float value, unsigned char decimals = 2) : text(format((double)value, decimals)) {}
+    String(double value, unsigned char decimals = 2) : text(format(value, decimals)) {}
+
+    const char* c_str() const { return text.c_str(); }
+    unsigned int length() const { return text.length(); }
+    bool reserve(unsigned int size) { text.reserve(size); return true; }
+    char operator[](unsigned int index) const { return index < text.length() ? text[index] : 0; }
+
+    String& operator+=(const String& other) { text += other.text; return *this; }
+    String& operator+=(const char* other) { text += other; return *this; }
+    String& operator+=(char c) { text += c; return *this; }
+    friend String operator+(const String& a, const String& b) { return String(a.text + b.text); }
+    friend String operator+(const String& a, const char* b) { return String(a.text + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b.text); }
+
+    bool operator==(const String& other) const { return text == other.text; }
+    bool operator==(const char* other) const { return text == other; }
+    bool operator!=(const String& other) const { return text != other.text; }
+    bool operator!=(const char* other) const { return text != other; }
+
+    bool startsWith(const char* prefix) const { return text.compare(0, strlen(prefix), prefix) == 0; }
+    int indexOf(char c, unsigned int from = 0) const;
+    String substring(unsigned int from) const { return substring(from, text.length()); }
+    String substring(unsigned int from, unsigned int to) const;
+    long toInt() const { return atol(text.c_str()); }
+    float toFloat() const { return atof(text.c_str()); }
+
+private:
+    std::string text;
+
+    static std::string format(long value, unsigned char base);
+    static std::string format(unsigned long value, unsigned char base);
+    static std::string format(double value, unsigned char decimals);
+};
+
+// Serial output is dropped unless NEOPIXEL_SERIAL is set in the environment
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+
+    template<typename T> size_t print(T value) { return write(String(value)); }
+    template<typename T> size_t print(T value, int format) { return write(String(value, format)); }
+    size_t println() { return write(String("\n")); }
+    template<typename T> size_t println(T value) { return print(value) + println(); }
+    template<typename T> size_t println(T value, int format) { return print(value, format) + println(); }
+
+private:
+    size_t write(const String& text);
+};
+
+extern HardwareSerial Serial;
+
+// Cycle counts are nanoseconds of the host's monotonic clock: a nominal 1 GHz CPU
+class EspClass {
+public:
+    void wdtFeed() {}
+    void restart() { exit(0); }
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 1000; }
+    uint32_t getFreeHeap() { return 40000; }
+    uint32_t random() { return (uint32_t)::random(0x7FFFFFFF); }
+};
+
+extern EspClass ESP;
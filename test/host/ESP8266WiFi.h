@@ -0,0 +1,13 @@
+// ESP8266WiFi.h - Host stand-in: a station that is always connected
+#pragma once
+
+#include <Arduino.h>
+
+#define WL_CONNECTED 3
+
+class ESP8266WiFiClass {
+public:
+    int status() { return WL_CONNECTED; }
+};
+
+extern ESP8266WiFiClass WiFi;
@@ -0,0 +1,7 @@
+// ESPAsyncWebServer.h - Host stand-in: only the names webserver.h declares
+#pragma once
+
+#include <Arduino.h>
+
+class AsyncWebServer;
+class AsyncWebServerRequest;
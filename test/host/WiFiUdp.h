@@ -0,0 +1,12 @@
+// WiFiUdp.h - Host stand-in for the UDP socket: never receives anything
+#pragma once
+
+#include <Arduino.h>
+
+class WiFiUDP {
+public:
+    uint8_t begin(uint16_t) { return 1; }
+    void stop() {}
+    int parsePacket() { return 0; }
+    int read(uint8_t*, size_t) { return 0; }
+};
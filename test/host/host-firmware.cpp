@@ -0,0 +1,30 @@
+// What main.cpp and webserver.cpp provide on the device, for the host build: the
+// shared settings the effects read, and a frame buffer whose output keeps the last
+// frame instead of driving a strip.
+#include "host-firmware.h"
+#include <ESP8266WiFi.h>
+
+ESP8266WiFiClass WiFi;
+
+volatile AnimationMode currentAnimation = ANIMATION_AUTO;
+volatile bool animationChanged = false;
+float animationSpeed = 1.0;
+
+uint32_t selectedColor = 0x00FF00;
+uint32_t drawingGrid[MATRIX_COLS][MATRIX_ROWS];
+
+float currentTemperature = -999.0;
+float currentHumidity = -999.0;
+bool temperatureValid = false;
+
+HostLedOutput ledOutput;
+FrameBuffer frameBuffer(ledOutput, MATRIX_PIXELS);
+
+bool HostLedOutput::show(const uint32_t* pixels, uint16_t count) {
+    if (count > MATRIX_PIXELS) {
+        count = MATRIX_PIXELS;
+    }
+    memcpy(frame, pixels, count * sizeof(uint32_t));
+    frames++;
+    return true;
+}
@@ -0,0 +1,24 @@
+// host-firmware.h - Device globals and the LED output of the host build
+#pragma once
+
+#include <Arduino.h>
+#include "webserver.h"
+#include "framebuffer.h"
+#include "matrix-geometry.h"
+
+// Takes every frame at once and keeps it for inspection (strip order, 0x00RRGGBB)
+class HostLedOutput : public LedOutput {
+public:
+    void begin() override {}
+    bool busy() override { return false; }
+    bool show(const uint32_t* pixels, uint16_t count) override;
+
+    const uint32_t* lastFrame() const { return frame; }
+    unsigned long getFrames() const { return frames; }
+
+private:
+    uint32_t frame[MATRIX_PIXELS] = {};
+    unsigned long frames = 0;
+};
+
+extern HostLedOutput ledOutput;
@@ -0,0 +1,15 @@
+// lwip/igmp.h - Host stand-in: group joins succeed and do nothing
+#pragma once
+
+#include <stdint.h>
+
+typedef struct { uint32_t addr; } ip4_addr_t;
+typedef int8_t err_t;
+
+#define ERR_OK 0
+#define IP4_ADDR_ANY4 ((const ip4_addr_t*)nullptr)
+#define IP4_ADDR(address, a, b, c, d) \
+    ((address)->addr = ((uint32_t)(d) << 24) | ((uint32_t)(c) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(a))
+
+inline err_t igmp_joingroup(const ip4_addr_t*, const ip4_addr_t*) { return ERR_OK; }
+inline err_t igmp_leavegroup(const ip4_addr_t*, const ip4_addr_t*) { return ERR_OK; }
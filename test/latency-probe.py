@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""Measure control latency of the matrix from a PC: p50, p99 and worst case.
+
+    test/latency-probe.py 192.168.1.50                 # 200 samples of each
+    test/latency-probe.py 192.168.1.50 --samples 1000 --mode 1
+
+Four measurements, each timed from sending to the complete answer:
+  http get      GET /getAnimation, a new connection per request (the server closes it)
+  http command  POST /setBrightness, answered once the change is queued
+  ws get        CMD_GET_STATE over the /ws WebSocket, until MSG_STATE comes back
+  ws applied    CMD_SET_BRIGHTNESS over /ws, until the MSG_STATE showing the new
+                brightness is pushed, i.e. the loop has applied it
+Run it with a busy effect selected (--mode, e.g. 4 for Nebula) to see that latency
+does not depend on the render loop. Brightness is toggled by one step and restored.
+"""
+import argparse
+import base64
+import os
+import socket
+import struct
+import time
+import urllib.request
+
+CMD_SET_BRIGHTNESS = 0x04
+CMD_GET_STATE = 0x06
+CMD_SET_MODE = 0x01
+MSG_STATE = 0x81
+STATE_BRIGHTNESS = 4  # byte of MSG_STATE holding the brightness
+
+
+class WebSocket:
+    """Just enough of RFC 6455 for binary messages to and from the device."""
+
+    def __init__(self, host, path="/ws", timeout=5):
+        self.sock = socket.create_connection((host, 80), timeout=timeout)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        key = base64.b64encode(os.urandom(16)).decode()
+        self.sock.sendall(("GET %s HTTP/1.1\r\nHost: %s\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                           "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n" % (path, host, key)).encode())
+        response = b""
+        while b"\r\n\r\n" not in response:
+            chunk = self.sock.recv(1024)
+            if not chunk:
+                raise ConnectionError("connection closed during the handshake")
+            response += chunk
+        if b" 101 " not in response.split(b"\r\n")[0]:
+            raise ConnectionError("no WebSocket at %s: %s" % (path, response.split(b"\r\n")[0].decode()))
+        self.buffer = response.split(b"\r\n\r\n", 1)[1]
+
+    def send(self, payload):
+        mask = os.urandom(4)
+        header = struct.pack("BB", 0x82, 0x80 | len(payload))  # commands are short
+        self.sock.sendall(header + mask + bytes(b ^ mask[i % 4] for i, b in enumerate(payload)))
+
+    def _read(self, n):
+        while len(self.buffer) < n:
+            chunk = self.sock.recv(4096)
+            if not chunk:
+                raise ConnectionError("connection closed")
+            self.buffer += chunk
+        data, self.buffer = self.buffer[:n], self.buffer[n:]
+        return data
+
+    def receive(self):
+        """Next binary message; pings and text frames are skipped."""
+        while True:
+            first, second = self._read(2)
+            length = second & 0x7F
+            if length == 126:
+                length = struct.unpack(">H", self._read(2))[0]
+            elif length == 127:
+                length = struct.unpack(">Q", self._read(8))[0]
+            payload = self._read(length)
+            if first & 0x0F == 0x02:
+                return payload
+
+    def receive_state(self):
+        while True:
+            message = self.receive()
+            if message[0] == MSG_STATE:
+                return message
+
+    def drain(self, quiet=0.3):
+        """Drop pushed messages until the device has been quiet for a while."""
+        self.sock.settimeout(quiet)
+        try:
+            while True:
+                self.receive()
+        except socket.timeout:
+            pass
+        self.buffer = b""
+        self.sock.settimeout(5)
+
+    def close(self):
+        self.sock.close()
+
+
+def percentile(samples, p):
+    ordered = sorted(samples)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p / 100))]
+
+
+def report(name, samples):
+    ms = [s * 1000 for s in samples]
+    print("%-14s %6d %9.1f %9.1f %9.1f" % (name, len(ms), percentile(ms, 50), percentile(ms, 99), max(ms)))
+
+
+def timed(function, samples, pause):
+    times = []
+    for _ in range(samples):
+        start = time.perf_counter()
+        function()
+        times.append(time.perf_counter() - start)
+        time.sleep(pause)
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host", help="device address")
+    parser.add_argument("--samples", type=int, default=200)
+    parser.add_argument("--pause", type=float, default=0.02, help="seconds between requests")
+    parser.add_argument("--mode", type=int, help="select this animation first")
+    args = parser.parse_args()
+    base = "http://%s" % args.host
+
+    ws = WebSocket(args.host)
+    state = ws.receive_state()  # pushed on connect
+    if args.mode is not None:
+        ws.send(bytes((CMD_SET_MODE, args.mode)))
+    ws.drain()
+    brightness = state[STATE_BRIGHTNESS]
+    other = brightness - 1 if brightness > 0 else 1
+
+    def http_get():
+        urllib.request.urlopen(base + "/getAnimation", timeout=5).read()
+
+    def http_command():
+        body = ("brightness=%d" % brightness).encode()
+        urllib.request.urlopen(base + "/setBrightness", data=body, timeout=5).read()
+
+    def ws_get():
+        ws.send(bytes((CMD_GET_STATE,)))
+        ws.receive_state()
+
+    toggle = [other, brightness]
+
+    def ws_applied():
+        value = toggle[0]
+        toggle.reverse()
+        ws.send(bytes((CMD_SET_BRIGHTNESS, value)))
+        while ws.receive_state()[STATE_BRIGHTNESS] != value:
+            pass
+
+    print("%-14s %6s %9s %9s %9s" % ("", "n", "p50 ms", "p99 ms", "max ms"))
+    report("http get", timed(http_get, args.samples, args.pause))
+    report("http command", timed(http_command, args.samples, args.pause))
+    ws.drain()
+    report("ws get", timed(ws_get, args.samples, args.pause))
+    report("ws applied", timed(ws_applied, args.samples, args.pause))
+
+    if toggle[0] == brightness:
+        ws.send(bytes((CMD_SET_BRIGHTNESS, brightness)))
+    ws.close()
+
+
+if __name__ == "__main__":
+    main()
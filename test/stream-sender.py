@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Send test frames to the matrix over DDP or E1.31 (sACN).
+
+    test/stream-sender.py 192.168.1.50                       # DDP rainbow, 40 fps, 10 s
+    test/stream-sender.py 192.168.1.50 --protocol e131 --terminate
+    test/stream-sender.py --protocol e131 --multicast        # to the universes' groups
+    test/stream-sender.py 192.168.1.50 --stale 0.1 --fps 100 # resend old packets
+
+Frames are 32x7 RGB pixels, row by row from the top left, as the device expects.
+--stale re-sends a packet of the previous frame after the next one started, which
+the device must count as late and drop. With --terminate the E1.31 stream ends with
+three terminated packets, which brings the previous animation back at once.
+Compare the device's /getStats "stream" counters with the totals printed at the end.
+"""
+import argparse
+import colorsys
+import random
+import socket
+import struct
+import time
+import uuid
+
+COLS, ROWS = 32, 7
+CHANNELS = COLS * ROWS * 3
+DDP_PORT = 4048
+E131_PORT = 5568
+UNIVERSE_CHANNELS = 510
+DDP_CHUNK = 480
+
+
+def pattern(name, frame):
+    pixels = bytearray(CHANNELS)
+    for row in range(ROWS):
+        for col in range(COLS):
+            i = (row * COLS + col) * 3
+            if name == "rainbow":
+                r, g, b = colorsys.hsv_to_rgb(((col + frame) % COLS) / COLS, 1.0, 0.5)
+                pixels[i:i + 3] = bytes((int(r * 255), int(g * 255), int(b * 255)))
+            elif name == "chase":
+                if col == frame % COLS:
+                    pixels[i:i + 3] = b"\xff\xff\xff"
+            else:
+                pixels[i:i + 3] = bytes(((frame * 3) & 0xFF, 0, 0x40))
+    return pixels
+
+
+def ddp_packets(frame, sequence):
+    """One frame as DDP packets; the push flag on the last one shows the frame."""
+    packets = []
+    for offset in range(0, CHANNELS, DDP_CHUNK):
+        data = frame[offset:offset + DDP_CHUNK]
+        sequence = sequence % 15 + 1
+        flags = 0x40 | (0x01 if offset + len(data) >= CHANNELS else 0)
+        header = struct.pack(">BBBBIH", flags, sequence, 0x0B, 0x01, offset, len(data))
+        packets.append(header + data)
+    return packets, sequence
+
+
+def e131_packet(cid, universe, sequence, data, options=0):
+    dmp = struct.pack(">HBBHHH", 0x7000 | (10 + len(data) + 1), 0x02, 0xA1, 0, 1, len(data) + 1) + b"\x00" + data
+    framing = (struct.pack(">HI", 0x7000 | (77 + len(dmp)), 0x00000002)
+               + b"stream-sender".ljust(64, b"\x00")
+               + struct.pack(">BHBBH", 100, 0, sequence, options, universe))
+    root = (struct.pack(">HH", 0x0010, 0x0000) + b"ASC-E1.17\x00\x00\x00"
+            + struct.pack(">HI", 0x7000 | (22 + len(framing) + len(dmp)), 0x00000004) + cid)
+    return root + framing + dmp
+
+
+def e131_packets(cid, frame, first_universe, sequences, options=0):
+    packets = []
+    for u, offset in enumerate(range(0, CHANNELS, UNIVERSE_CHANNELS)):
+        universe = first_universe + u
+        sequences[universe] = (sequences.get(universe, 0) + 1) & 0xFF
+        packets.append((universe, e131_packet(cid, universe, sequences[universe],
+                                              frame[offset:offset + UNIVERSE_CHANNELS], options)))
+    return packets
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host", nargs="?", help="device address (omit with --multicast)")
+    parser.add_argument("--protocol", choices=("ddp", "e131"), default="ddp")
+    parser.add_argument("--pattern", choices=("rainbow", "chase", "solid"), default="rainbow")
+    parser.add_argument("--fps", type=float, default=40)
+    parser.add_argument("--seconds", type=float, default=10)
+    parser.add_argument("--universe", type=int, default=1, help="first E1.31 universe (STREAM_UNIVERSE)")
+    parser.add_argument("--multicast", action="store_true", help="send E1.31 to 239.255.<universe>")
+    parser.add_argument("--stale", type=float, default=0, help="chance per frame of re-sending an old packet")
+    parser.add_argument("--terminate", action="store_true", help="end an E1.31 stream with terminated packets")
+    args = parser.parse_args()
+    if not args.host and not (args.multicast and args.protocol == "e131"):
+        parser.error("a host is needed unless E1.31 is sent with --multicast")
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, 4)
+    cid = uuid.uuid4().bytes
+    sequence = 0
+    sequences = {}
+    stale = None
+    sent = stale_sent = 0
+
+    def destination(universe):
+        if args.multicast:
+            return ("239.255.%d.%d" % (universe >> 8, universe & 0xFF), E131_PORT)
+        return (args.host, E131_PORT if args.protocol == "e131" else DDP_PORT)
+
+    frames = int(args.seconds * args.fps)
+    start = time.monotonic()
+    for n in range(frames):
+        frame = pattern(args.pattern, n)
+        if args.protocol == "ddp":
+            packets, sequence = ddp_packets(frame, sequence)
+            packets = [(None, p) for p in packets]
+        else:
+            packets = e131_packets(cid, frame, args.universe, sequences)
+
+        for i, (universe, packet) in enumerate(packets):
+            sock.sendto(packet, destination(universe))
+            sent += 1
+            if i == 0 and stale and random.random() < args.stale:
+                sock.sendto(stale[1], destination(stale[0]))
+                stale_sent += 1
+        stale = packets[0]
+
+        # Pace against the start time so the rate does not drift
+        delay = start + (n + 1) / args.fps - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+
+    if args.protocol == "e131" and args.terminate:
+        last = pattern(args.pattern, frames)
+        for _ in range(3):
+            for universe, packet in e131_packets(cid, last, args.universe, sequences, options=0x40):
+                sock.sendto(packet, destination(universe))
+
+    print("%d frames, %d packets, %d stale packets re-sent (expect %d late)" % (frames, sent, stale_sent, stale_sent))
+
+
+if __name__ == "__main__":
+    main()
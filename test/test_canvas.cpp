@@ -0,0 +1,82 @@
+// Canvas blending, the colour pipeline and the frame buffer's change detection
+#include "unit-test.h"
+#include "host-firmware.h"
+#include "canvas.h"
+#include "color-pipeline.h"
+
+TEST(blend_add_saturates) {
+    Rgb16 result = Canvas::blend({ 0xF000, 0x1000, 0 }, { 0x2000, 0x1000, 0 }, BLEND_ADD, 255);
+    CHECK_EQUAL(0xFFFF, result.r);
+    CHECK_EQUAL(0x2000, result.g);
+    CHECK_EQUAL(0, result.b);
+}
+
+TEST(blend_alpha_ends) {
+    Rgb16 dst = { 1000, 2000, 3000 };
+    Rgb16 src = { 50000, 0, 3000 };
+    Rgb16 full = Canvas::blend(dst, src, BLEND_ALPHA, 255);
+    CHECK_EQUAL(50000, full.r);
+    CHECK_EQUAL(0, full.g);
+    CHECK_EQUAL(3000, full.b);
+    // alpha 0 still moves 1/256 of the way, so the destination barely changes
+    Rgb16 none = Canvas::blend(dst, src, BLEND_ALPHA, 0);
+    CHECK(none.r >= 1000 && none.r < 1200);
+}
+
+TEST(blend_multiply_and_max) {
+    Rgb16 dst = { 40000, 40000, 40000 };
+    CHECK_EQUAL(40000, Canvas::blend(dst, { 0xFFFF, 0, 0 }, BLEND_MULTIPLY, 255).r);
+    CHECK_EQUAL(0, Canvas::blend(dst, { 0xFFFF, 0, 0 }, BLEND_MULTIPLY, 255).g);
+    CHECK_EQUAL(50000, Canvas::blend(dst, { 50000, 100, 0 }, BLEND_MAX, 255).r);
+    CHECK_EQUAL(40000, Canvas::blend(dst, { 50000, 100, 0 }, BLEND_MAX, 255).g);
+}
+
+TEST(gamma_table_ends) {
+    Rgb16 black = colorPipeline.toLinear(0x000000);
+    Rgb16 white = colorPipeline.toLinear(0xFFFFFF);
+    CHECK_EQUAL(0, black.r);
+    CHECK_EQUAL(0xFFFF, white.r);
+    CHECK_EQUAL(0xFFFF, white.b);
+    // Gamma 2.2: half input is well under half the light
+    CHECK(colorPipeline.toLinear(0x800000).r < 0x4000);
+}
+
+TEST(dithering_averages_between_steps) {
+    // 2.5 8-bit steps of light: refreshes alternate between 2 and 3
+    Rgb16 in = { 640, 0, 0 };
+    uint32_t out = 0;
+    uint8_t residual[3] = {};
+    uint32_t total = 0;
+    for (int i = 0; i < 256; i++) {
+        CHECK(colorPipeline.process(&in, &out, residual, 1));
+        total += out >> 16;
+    }
+    CHECK_EQUAL(640u, total);
+}
+
+TEST(brightness_zero_is_black) {
+    Rgb16 in = { 0xFFFF, 0x8000, 0x0100 };
+    uint32_t out = 0xFFFFFF;
+    uint8_t residual[3] = {};
+    colorPipeline.setBrightness(0);
+    colorPipeline.process(&in, &out, residual, 1);
+    colorPipeline.setBrightness(255);
+    CHECK_EQUAL(0u, out);
+}
+
+TEST(frame_buffer_skips_unchanged_frames) {
+    frameBuffer.fill(0x102030);
+    frameBuffer.show();
+    unsigned long sent = ledOutput.getFrames();
+    unsigned long skipped = frameBuffer.getFramesSkipped();
+
+    // Redrawing the same picture sends nothing
+    frameBuffer.fill(0x102030);
+    CHECK(!frameBuffer.show());
+    CHECK_EQUAL(sent, ledOutput.getFrames());
+    CHECK_EQUAL(skipped + 1, frameBuffer.getFramesSkipped());
+
+    frameBuffer.setPixelColor(5, 0xFF0000);
+    CHECK(frameBuffer.show());
+    CHECK_EQUAL(sent + 1, ledOutput.getFrames());
+}
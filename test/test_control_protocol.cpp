@@ -0,0 +1,215 @@
+// Every control channel command decoded against a recording target, with messages
+// cut short or run long, and the device messages encoded for clients
+#include "unit-test.h"
+#include "control-protocol.h"
+
+#include <vector>
+
+// Remembers the last call and its arguments; setters return accept
+class RecordingTarget : public ControlTarget {
+public:
+    std::string call;
+    std::vector<uint32_t> args;
+    std::string text;
+    int calls = 0;
+    bool accept = true;
+
+    bool setMode(uint8_t mode) override { return record("setMode", { mode }); }
+    bool setSpeed(uint16_t speed) override { return record("setSpeed", { speed }); }
+    void setColor(uint32_t color) override { record("setColor", { color }); }
+    void setBrightness(uint8_t brightness) override { record("setBrightness", { brightness }); }
+    bool setFrame(const uint8_t* data, size_t length) override {
+        text.assign((const char*)data, length);
+        return record("setFrame", { (uint32_t)length });
+    }
+    bool setPowerLimit(uint16_t milliamps) override { return record("setPowerLimit", { milliamps }); }
+    bool setTransition(uint8_t style, uint16_t durationMs) override {
+        return record("setTransition", { style, durationMs });
+    }
+    bool setPalette(uint8_t mode, uint8_t palette) override { return record("setPalette", { mode, palette }); }
+    bool setCustomPalette(const uint8_t* stops, uint8_t count) override {
+        return record("setCustomPalette", { count, stops[0], stops[count * 4 - 1] });
+    }
+    bool setMarquee(uint8_t fields, uint8_t speed, uint32_t color, bool smooth,
+                    const char* text, size_t textLength) override {
+        this->text.assign(text, textLength);
+        return record("setMarquee", { fields, speed, color, smooth });
+    }
+    bool setPixel(uint8_t col, uint8_t row, bool on) override { return record("setPixel", { col, row, on }); }
+    void clearGrid() override { record("clearGrid", {}); }
+    void fillGrid() override { record("fillGrid", {}); }
+    void drawBorder() override { record("drawBorder", {}); }
+    void resetStats() override { record("resetStats", {}); }
+    void runSelfTest(bool rebaseline) override { record("runSelfTest", { rebaseline }); }
+    void resetWiFi() override { record("resetWiFi", {}); }
+
+private:
+    bool record(const char* name, std::vector<uint32_t> values) {
+        call = name;
+        args = values;
+        calls++;
+        return accept;
+    }
+};
+
+struct FixedCommand {
+    std::vector<uint8_t> message;
+    const char* call;
+    std::vector<uint32_t> args;
+    bool refusable;  // the target may refuse the value
+};
+
+// Commands whose payload has one exact length
+static const FixedCommand FIXED[] = {
+    { { CMD_SET_MODE, 4 }, "setMode", { 4 }, true },
+    { { CMD_SET_SPEED, 0x40, 0x01 }, "setSpeed", { 320 }, true },
+    { { CMD_SET_COLOR, 0x12, 0x34, 0x56 }, "setColor", { 0x123456 }, false },
+    { { CMD_SET_BRIGHTNESS, 200 }, "setBrightness", { 200 }, false },
+    { { CMD_SET_POWER_LIMIT, 0xC4, 0x09 }, "setPowerLimit", { 2500 }, true },
+    { { CMD_SET_TRANSITION, 1, 0xE8, 0x03 }, "setTransition", { 1, 1000 }, true },
+    { { CMD_SET_PALETTE, 6, 2 }, "setPalette", { 6, 2 }, true },
+    { { CMD_SET_PIXEL, 31, 6, 1 }, "setPixel", { 31, 6, 1 }, true },
+    { { CMD_CLEAR_GRID }, "clearGrid", {}, false },
+    { { CMD_FILL_GRID }, "fillGrid", {}, false },
+    { { CMD_DRAW_BORDER }, "drawBorder", {}, false },
+    { { CMD_RESET_STATS }, "resetStats", {}, false },
+    { { CMD_SELF_TEST, 1 }, "runSelfTest", { 1 }, false },
+    { { CMD_RESET_WIFI }, "resetWiFi", {}, false },
+};
+
+static ControlResult send(ControlTarget& target, const std::vector<uint8_t>& message) {
+    return ControlProtocol::handle(target, message.data(), message.size());
+}
+
+TEST(fixed_length_commands_decode) {
+    for (const FixedCommand& command : FIXED) {
+        RecordingTarget target;
+        CHECK_EQUAL(CONTROL_DONE, send(target, command.message));
+        CHECK_EQUAL(std::string(command.call), target.call);
+        CHECK(command.args == target.args);
+    }
+}
+
+TEST(fixed_length_commands_reject_wrong_lengths) {
+    for (const FixedCommand& command : FIXED) {
+        RecordingTarget target;
+        std::vector<uint8_t> longer = command.message;
+        longer.push_back(0);
+        CHECK_EQUAL(CONTROL_REJECTED, send(target, longer));
+        if (command.message.size() > 1) {
+            std::vector<uint8_t> shorter(command.message.begin(), command.message.end() - 1);
+            CHECK_EQUAL(CONTROL_REJECTED, send(target, shorter));
+        }
+        CHECK_EQUAL(0, target.calls);
+    }
+}
+
+TEST(target_refusal_is_rejected) {
+    for (const FixedCommand& command : FIXED) {
+        RecordingTarget target;
+        target.accept = false;
+        ControlResult result = send(target, command.message);
+        CHECK_EQUAL(1, target.calls);
+        // Commands that cannot fail are applied whatever the target would say
+        CHECK_EQUAL(command.refusable ? CONTROL_REJECTED : CONTROL_DONE, result);
+    }
+}
+
+TEST(get_state_takes_no_payload) {
+    RecordingTarget target;
+    CHECK_EQUAL(CONTROL_GET_STATE, send(target, { CMD_GET_STATE }));
+    CHECK_EQUAL(CONTROL_REJECTED, send(target, { CMD_GET_STATE, 0 }));
+    CHECK_EQUAL(0, target.calls);
+}
+
+TEST(frame_passes_its_body_through) {
+    RecordingTarget target;
+    CHECK_EQUAL(CONTROL_DONE, send(target, { CMD_FRAME, 'A', 'B', 'C' }));
+    CHECK_EQUAL(std::string("setFrame"), target.call);
+    CHECK_EQUAL(std::string("ABC"), target.text);
+    // The body is checked by the target; an empty or refused one is rejected
+    target.accept = false;
+    CHECK_EQUAL(CONTROL_REJECTED, send(target, { CMD_FRAME }));
+}
+
+TEST(palette_upload_takes_whole_stops) {
+    RecordingTarget target;
+    std::vector<uint8_t> message = { CMD_UPLOAD_PALETTE, 0, 255, 0, 0, 255, 0, 0, 255 };
+    CHECK_EQUAL(CONTROL_DONE, send(target, message));
+    CHECK_EQUAL(std::string("setCustomPalette"), target.call);
+    CHECK(target.args == std::vector<uint32_t>({ 2, 0, 255 }));
+
+    // Partial stops, no stops and more than 16 are refused before the target sees them
+    target.calls = 0;
+    message.pop_back();
+    CHECK_EQUAL(CONTROL_REJECTED, send(target, message));
+    CHECK_EQUAL(CONTROL_REJECTED, send(target, { CMD_UPLOAD_PALETTE }));
+    std::vector<uint8_t> oversized(1 + 4 * (ControlProtocol::MAX_PALETTE_STOPS + 1), 0);
+    oversized[0] = CMD_UPLOAD_PALETTE;
+    CHECK_EQUAL(CONTROL_REJECTED, send(target, oversized));
+    oversized.resize(1 + 4 * ControlProtocol::MAX_PALETTE_STOPS);
+    CHECK_EQUAL(CONTROL_DONE, send(target, oversized));
+    CHECK_EQUAL(1, target.calls);
+}
+
+TEST(marquee_text_is_the_rest_of_the_message) {
+    RecordingTarget target;
+    std::vector<uint8_t> message = { CMD_SET_MARQUEE, MARQUEE_TEXT | MARQUEE_COLOR, 40, 0xFF, 0x80, 0x00, 1 };
+    const char* text = "Hello";
+    message.insert(message.end(), text, text + 5);
+    CHECK_EQUAL(CONTROL_DONE, send(target, message));
+    CHECK_EQUAL(std::string("setMarquee"), target.call);
+    CHECK(target.args == std::vector<uint32_t>({ MARQUEE_TEXT | MARQUEE_COLOR, 40, 0xFF8000, 1 }));
+    CHECK_EQUAL(std::string("Hello"), target.text);
+
+    // The header alone is a valid empty text; anything shorter is cut off
+    message.resize(ControlProtocol::MARQUEE_HEADER);
+    CHECK_EQUAL(CONTROL_DONE, send(target, message));
+    CHECK_EQUAL(std::string(""), target.text);
+    target.calls = 0;
+    message.pop_back();
+    CHECK_EQUAL(CONTROL_REJECTED, send(target, message));
+    CHECK_EQUAL(0, target.calls);
+}
+
+TEST(unknown_and_empty_messages_are_rejected) {
+    RecordingTarget target;
+    CHECK_EQUAL(CONTROL_REJECTED, ControlProtocol::handle(target, nullptr, 0));
+    CHECK_EQUAL(CONTROL_REJECTED, send(target, { 0x00 }));
+    CHECK_EQUAL(CONTROL_REJECTED, send(target, { 0x13 }));
+    CHECK_EQUAL(CONTROL_REJECTED, send(target, { MSG_STATE, 1, 2, 3 }));
+    CHECK_EQUAL(0, target.calls);
+}
+
+TEST(errors_name_the_rejected_opcode) {
+    uint8_t out[ControlProtocol::ERROR_LENGTH];
+    const uint8_t command[] = { CMD_SET_SPEED, 99, 0 };
+    CHECK_EQUAL(ControlProtocol::ERROR_LENGTH, ControlProtocol::encodeError(command, sizeof(command), out));
+    CHECK_EQUAL(MSG_ERROR, out[0]);
+    CHECK_EQUAL(CMD_SET_SPEED, out[1]);
+
+    CHECK_EQUAL(ControlProtocol::ERROR_LENGTH, ControlProtocol::encodeError(command, 0, out));
+    CHECK_EQUAL(0, out[1]);
+}
+
+TEST(state_and_sensor_encoding) {
+    uint8_t out[ControlProtocol::MAX_STATE_LENGTH];
+    // Speed 1.23 goes out as the 8.8 value the clock runs at, not rounded to tenths
+    ControlState state = { 3, 315, 255, 0x0A0B0C, "Nebula Swirl" };
+    size_t length = ControlProtocol::encodeState(state, out);
+    CHECK_EQUAL(ControlProtocol::STATE_HEADER + 12, length);
+    const uint8_t header[] = { MSG_STATE, 3, 0x3B, 0x01, 255, 0x0A, 0x0B, 0x0C };
+    CHECK(memcmp(header, out, sizeof(header)) == 0);
+    CHECK(memcmp("Nebula Swirl", out + ControlProtocol::STATE_HEADER, 12) == 0);
+
+    // Long names are cut at MAX_NAME_LENGTH
+    std::string longName(40, 'x');
+    state.name = longName.c_str();
+    CHECK_EQUAL(ControlProtocol::MAX_STATE_LENGTH, ControlProtocol::encodeState(state, out));
+
+    SensorReading reading = { -15, ControlProtocol::UNKNOWN_READING };
+    CHECK_EQUAL(ControlProtocol::SENSOR_LENGTH, ControlProtocol::encodeSensor(reading, out));
+    CHECK_EQUAL(MSG_SENSOR, out[0]);
+    CHECK_EQUAL(-15, (int16_t)(out[1] | out[2] << 8));
+    CHECK_EQUAL(ControlProtocol::UNKNOWN_READING, (int16_t)(out[3] | out[4] << 8));
+}
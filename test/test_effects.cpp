@@ -0,0 +1,103 @@
+// Every registered effect runs frame by frame on the host and gives its arena back
+#include "unit-test.h"
+#include "host-firmware.h"
+#include "animation.h"
+#include "prng.h"
+
+static const uint32_t FRAME_DT_US = 20000;
+
+// Play an effect for frames frames the way the render task does
+static void play(AnimationMode mode, int frames) {
+    animationPlayer.select(mode);
+    for (int i = 0; i < frames; i++) {
+        hostAdvanceMicros(FRAME_DT_US);
+        animationPlayer.frame(FRAME_DT_US);
+    }
+}
+
+TEST(registry_matches_modes) {
+    for (int mode = 0; mode < ANIMATION_MODE_COUNT; mode++) {
+        Animation* animation = AnimationRegistry::get(mode);
+        CHECK(animation != nullptr);
+        if (animation) {
+            CHECK_EQUAL(mode, (int)animation->getMode());
+            CHECK(animation->stateBytes() <= AnimationRegistry::arenaSize());
+        }
+    }
+    CHECK(AnimationRegistry::get(ANIMATION_MODE_COUNT) == nullptr);
+    CHECK(AnimationRegistry::get(-1) == nullptr);
+}
+
+TEST(every_effect_runs_and_releases_its_state) {
+    temperatureValid = true;
+    currentTemperature = 23.4;
+    for (int mode = 0; mode < ANIMATION_MODE_COUNT; mode++) {
+        play((AnimationMode)mode, 100);
+        CHECK(AnimationRegistry::arenaUsed() <= AnimationRegistry::arenaSize());
+        animationPlayer.stop();
+        CHECK_EQUAL((size_t)0, AnimationRegistry::arenaUsed());
+    }
+}
+
+TEST(auto_cycle_survives_transitions) {
+    // Long enough for several playlist entries and the transitions between them
+    play(ANIMATION_AUTO, 50 * 45);
+    CHECK(animationPlayer.visible() != nullptr);
+    CHECK(AnimationRegistry::arenaUsed() <= AnimationRegistry::arenaSize());
+    animationPlayer.stop();
+    CHECK_EQUAL((size_t)0, AnimationRegistry::arenaUsed());
+}
+
+TEST(seeded_effects_repeat_exactly) {
+    uint32_t first[MATRIX_PIXELS];
+    Prng::setBaseSeed(1234);
+    play(ANIMATION_FIRE, 60);
+    memcpy(first, ledOutput.lastFrame(), sizeof(first));
+    animationPlayer.stop();
+
+    Prng::setBaseSeed(1234);
+    play(ANIMATION_FIRE, 60);
+    CHECK(memcmp(first, ledOutput.lastFrame(), sizeof(first)) == 0);
+    animationPlayer.stop();
+}
+
+TEST(temperature_is_drawn) {
+    temperatureValid = true;
+    currentTemperature = 21.5;
+    play(ANIMATION_TEMPERATURE, 2);
+    int lit = 0;
+    for (int i = 0; i < MATRIX_PIXELS; i++) {
+        if (ledOutput.lastFrame()[i]) lit++;
+    }
+    CHECK(lit > 20);
+    animationPlayer.stop();
+}
+
+TEST(full_arena_leaves_running_effects_alone) {
+    // Two slots: a third effect starting alongside a transition gets none
+    Animation* qix = AnimationRegistry::get(ANIMATION_QIX_LINES);
+    Animation* fire = AnimationRegistry::get(ANIMATION_FIRE);
+    Animation* nebula = AnimationRegistry::get(ANIMATION_NEBULA);
+    qix->begin();
+    fire->begin();
+    size_t used = AnimationRegistry::arenaUsed();
+    CHECK_EQUAL(qix->stateBytes() + fire->stateBytes(), used);
+
+    nebula->begin();
+    CHECK_EQUAL(used, AnimationRegistry::arenaUsed());
+    frameBuffer.fill(0xFFFFFF);
+    nebula->update(FRAME_DT_US);
+    nebula->render(frameBuffer);
+    frameBuffer.show();
+    CHECK_EQUAL(0u, ledOutput.lastFrame()[0]);
+
+    // The running effects still draw from their own state
+    qix->update(FRAME_DT_US);
+    qix->render(frameBuffer);
+    fire->update(FRAME_DT_US);
+    nebula->end();
+    CHECK_EQUAL(used, AnimationRegistry::arenaUsed());
+    qix->end();
+    fire->end();
+    CHECK_EQUAL((size_t)0, AnimationRegistry::arenaUsed());
+}
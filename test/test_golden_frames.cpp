@@ -0,0 +1,121 @@
+// Golden-frame check of the effects on the host: every frame of the replay suite is
+// hashed and compared with the goldens committed in test/golden, one file per effect
+// with a hash per line. After a deliberate change of look, store new goldens with
+//   UPDATE_GOLDEN=1 ctest --test-dir build -R test_golden_frames
+// and commit them with the change. Render time per frame is printed alongside.
+#include "unit-test.h"
+#include "host-firmware.h"
+#include "golden-frames.h"
+
+#include <stdlib.h>
+#include <fstream>
+
+static const char* GOLDEN_DIR = "test/golden/";
+
+// "All Red (10%)" -> test/golden/all-red-10.txt
+static std::string goldenPath(const char* name) {
+    std::string slug;
+    for (const char* c = name; *c; c++) {
+        if (isalnum((unsigned char)*c)) {
+            slug += (char)tolower(*c);
+        } else if (!slug.empty() && slug.back() != '-') {
+            slug += '-';
+        }
+    }
+    while (!slug.empty() && slug.back() == '-') slug.pop_back();
+    return GOLDEN_DIR + slug + ".txt";
+}
+
+static std::vector<uint32_t> readGolden(const std::string& path) {
+    std::vector<uint32_t> hashes;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty()) hashes.push_back((uint32_t)strtoul(line.c_str(), nullptr, 16));
+    }
+    return hashes;
+}
+
+static void writeGolden(const std::string& path, const std::vector<uint32_t>& hashes) {
+    std::ofstream out(path);
+    char line[16];
+    for (uint32_t hash : hashes) {
+        snprintf(line, sizeof(line), "%08x\n", hash);
+        out << line;
+    }
+    CHECK(out.good());
+}
+
+TEST(effects_match_their_golden_frames) {
+    bool update = getenv("UPDATE_GOLDEN") && atoi(getenv("UPDATE_GOLDEN"));
+    GoldenReplay replay;
+    std::vector<uint32_t> hashes;
+    uint64_t totalCycles = 0;
+    uint32_t maxCycles = 0;
+
+    replay.start();
+    while (replay.step()) {
+        hashes.push_back(replay.getHash());
+        totalCycles += replay.getCycles();
+        if (replay.getCycles() > maxCycles) maxCycles = replay.getCycles();
+        if (!replay.isLastFrame()) continue;
+
+        const char* name = replay.getAnimation()->getName();
+        std::string path = goldenPath(name);
+        const char* status = "pass";
+        if (update) {
+            writeGolden(path, hashes);
+            status = "baselined";
+        } else {
+            std::vector<uint32_t> golden = readGolden(path);
+            if (golden.size() != hashes.size()) {
+                printf("%s: no golden frames, run with UPDATE_GOLDEN=1\n", path.c_str());
+                status = "no golden";
+                CHECK(golden.size() == hashes.size());
+            } else {
+                for (size_t frame = 0; frame < hashes.size(); frame++) {
+                    if (golden[frame] != hashes[frame]) {
+                        printf("%s: frame %zu differs (%08x, golden %08x)\n", name, frame, hashes[frame], golden[frame]);
+                        status = "fail";
+                        CHECK(golden[frame] == hashes[frame]);
+                        break;
+                    }
+                }
+            }
+        }
+        // Cycles are nanoseconds on the host
+        printf("%-14s %-9s avg %6llu ns  max %7u ns\n", name, status,
+               (unsigned long long)(totalCycles / GoldenReplay::FRAMES), maxCycles);
+
+        hashes.clear();
+        totalCycles = 0;
+        maxCycles = 0;
+    }
+    CHECK(!replay.isRunning());
+    CHECK_EQUAL((size_t)0, AnimationRegistry::arenaUsed());
+}
+
+TEST(replay_can_stop_midway) {
+    GoldenReplay replay;
+    replay.start();
+    for (int i = 0; i < GoldenReplay::FRAMES + 10; i++) replay.step();
+    CHECK(AnimationRegistry::arenaUsed() > 0);
+    replay.abort();
+    CHECK(!replay.isRunning());
+    CHECK_EQUAL((size_t)0, AnimationRegistry::arenaUsed());
+    CHECK(!replay.step());
+}
+
+TEST(replays_are_repeatable) {
+    // Whatever ran before, a run starts from the same seed sequence
+    GoldenReplay first;
+    first.start();
+    for (int i = 0; i < 30; i++) first.step();
+    uint32_t hash = first.getHash();
+    first.abort();
+
+    GoldenReplay second;
+    second.start();
+    for (int i = 0; i < 30; i++) second.step();
+    CHECK_EQUAL(hash, second.getHash());
+}
@@ -0,0 +1,55 @@
+// The power limiter's current estimate and how it dims frames over the budget
+#include "unit-test.h"
+#include "host-firmware.h"
+#include "power-limiter.h"
+
+static void fill(uint32_t* pixels, uint32_t color) {
+    for (int i = 0; i < MATRIX_PIXELS; i++) pixels[i] = color;
+}
+
+TEST(estimate_counts_channels_and_idle) {
+    uint32_t pixels[MATRIX_PIXELS];
+    fill(pixels, 0x000000);
+    CHECK_EQUAL((uint32_t)MATRIX_PIXELS * PowerLimiter::MA_IDLE, powerLimiter.estimate(pixels, MATRIX_PIXELS));
+    fill(pixels, 0xFFFFFF);
+    uint32_t perPixel = PowerLimiter::MA_RED + PowerLimiter::MA_GREEN + PowerLimiter::MA_BLUE + PowerLimiter::MA_IDLE;
+    CHECK_EQUAL((uint32_t)MATRIX_PIXELS * perPixel, powerLimiter.estimate(pixels, MATRIX_PIXELS));
+}
+
+TEST(frames_within_budget_pass_unchanged) {
+    PowerLimiter limiter(2500);
+    uint32_t pixels[MATRIX_PIXELS];
+    fill(pixels, 0x202020);
+    CHECK(!limiter.apply(pixels, MATRIX_PIXELS));
+    CHECK_EQUAL(0x202020u, pixels[0]);
+    CHECK_EQUAL(0ul, limiter.getLimitedFrames());
+}
+
+TEST(frames_over_budget_are_scaled_to_fit) {
+    PowerLimiter limiter(2500);
+    uint32_t pixels[MATRIX_PIXELS];
+    fill(pixels, 0xFFFFFF);
+    CHECK(limiter.apply(pixels, MATRIX_PIXELS));
+    CHECK(limiter.getEstimatedMa() <= 2500);
+    CHECK(limiter.getEstimatedMa() > 2300);
+    CHECK(limiter.getRequestedMa() > 2500);
+    CHECK(pixels[0] != 0);
+    CHECK_EQUAL(1ul, limiter.getLimitedFrames());
+}
+
+TEST(limit_below_idle_draw_goes_black) {
+    // Nothing is left for the channels once the idle draw is paid
+    PowerLimiter limiter(MATRIX_PIXELS * PowerLimiter::MA_IDLE);
+    uint32_t pixels[MATRIX_PIXELS];
+    fill(pixels, 0x804020);
+    CHECK(limiter.apply(pixels, MATRIX_PIXELS));
+    bool black = true;
+    for (int i = 0; i < MATRIX_PIXELS; i++) black &= pixels[i] == 0;
+    CHECK(black);
+    CHECK_EQUAL((uint32_t)MATRIX_PIXELS * PowerLimiter::MA_IDLE, limiter.getEstimatedMa());
+
+    limiter.setLimit(10);
+    fill(pixels, 0xFFFFFF);
+    CHECK(limiter.apply(pixels, MATRIX_PIXELS));
+    CHECK_EQUAL(0u, pixels[MATRIX_PIXELS - 1]);
+}
@@ -0,0 +1,196 @@
+// DDP and E1.31 decoding against packets built here the way xLights and LedFx send
+// them, including a soak of reordered traffic and terminations for other universes
+#include "unit-test.h"
+#include "stream-protocol.h"
+#include "prng.h"
+
+static const uint16_t CHANNELS = StreamDecoder::CHANNELS;
+
+static std::vector<uint8_t> ddpPacket(uint8_t sequence, uint32_t offset, const uint8_t* data, uint16_t length, bool push) {
+    std::vector<uint8_t> packet = {
+        (uint8_t)(0x40 | (push ? 0x01 : 0)), sequence, 0x0B, 0x01,
+        (uint8_t)(offset >> 24), (uint8_t)(offset >> 16), (uint8_t)(offset >> 8), (uint8_t)offset,
+        (uint8_t)(length >> 8), (uint8_t)length
+    };
+    packet.insert(packet.end(), data, data + length);
+    return packet;
+}
+
+static const uint8_t E131_PREVIEW = 0x80;
+static const uint8_t E131_TERMINATED = 0x40;
+
+static std::vector<uint8_t> e131Packet(uint16_t universe, uint8_t sequence, const uint8_t* data, uint16_t length,
+                                       uint8_t options = 0) {
+    std::vector<uint8_t> packet(126, 0);
+    // Root layer
+    packet[1] = 0x10;
+    memcpy(&packet[4], "ASC-E1.17\0\0\0", 12);
+    packet[21] = 0x04;
+    // Framing layer
+    packet[43] = 0x02;
+    memcpy(&packet[44], "host test", 9);
+    packet[108] = 100;
+    packet[111] = sequence;
+    packet[112] = options;
+    packet[113] = universe >> 8;
+    packet[114] = universe & 0xFF;
+    // DMP layer: set property, start code 0
+    packet[117] = 0x02;
+    packet[118] = 0xA1;
+    packet[122] = 0x01;
+    packet[123] = (length + 1) >> 8;
+    packet[124] = (length + 1) & 0xFF;
+    packet.insert(packet.end(), data, data + length);
+    return packet;
+}
+
+static StreamResult send(StreamDecoder& decoder, const std::vector<uint8_t>& packet, bool ddp) {
+    return ddp ? decoder.receiveDdp(packet.data(), packet.size()) : decoder.receiveE131(packet.data(), packet.size());
+}
+
+static bool frameIs(const StreamDecoder& decoder, uint8_t value) {
+    for (uint16_t i = 0; i < CHANNELS; i++) {
+        if (decoder.frame()[i] != value) return false;
+    }
+    return true;
+}
+
+TEST(ddp_frame_is_published_on_push) {
+    StreamDecoder decoder;
+    std::vector<uint8_t> data(CHANNELS, 0x42);
+    CHECK_EQUAL(STREAM_DATA, send(decoder, ddpPacket(1, 0, data.data(), 300, false), true));
+    CHECK(frameIs(decoder, 0));
+    CHECK_EQUAL(STREAM_FRAME, send(decoder, ddpPacket(2, 300, data.data(), 100, true), true));
+    CHECK_EQUAL(0x42, decoder.frame()[399]);
+    CHECK_EQUAL(0, decoder.frame()[400]);
+    CHECK_EQUAL(1u, decoder.getFrames());
+}
+
+TEST(ddp_frame_is_published_at_the_last_channel) {
+    StreamDecoder decoder;
+    std::vector<uint8_t> data(CHANNELS, 0x17);
+    CHECK_EQUAL(STREAM_FRAME, send(decoder, ddpPacket(0, 0, data.data(), CHANNELS, false), true));
+    CHECK(frameIs(decoder, 0x17));
+}
+
+TEST(ddp_late_packets_are_dropped) {
+    StreamDecoder decoder;
+    std::vector<uint8_t> data(CHANNELS, 0x10);
+    send(decoder, ddpPacket(5, 0, data.data(), 10, false), true);
+    CHECK_EQUAL(STREAM_LATE, send(decoder, ddpPacket(4, 0, data.data(), 10, false), true));
+    // 15 wraps to 1; a packet 8 or more behind is taken as the sender restarting
+    CHECK_EQUAL(STREAM_DATA, send(decoder, ddpPacket(12, 0, data.data(), 10, false), true));
+    CHECK_EQUAL(STREAM_DATA, send(decoder, ddpPacket(1, 0, data.data(), 10, false), true));
+    CHECK_EQUAL(STREAM_LATE, send(decoder, ddpPacket(14, 0, data.data(), 10, false), true));
+    CHECK_EQUAL(2u, decoder.getLate());
+}
+
+TEST(ddp_rejects_other_versions_and_queries) {
+    StreamDecoder decoder;
+    uint8_t data[3] = { 1, 2, 3 };
+    std::vector<uint8_t> packet = ddpPacket(1, 0, data, 3, true);
+    packet[0] = 0x81;
+    CHECK_EQUAL(STREAM_INVALID, send(decoder, packet, true));
+    packet[0] = 0x43;
+    CHECK_EQUAL(STREAM_INVALID, send(decoder, packet, true));
+    CHECK_EQUAL(STREAM_INVALID, send(decoder, std::vector<uint8_t>(packet.begin(), packet.begin() + 9), true));
+    CHECK_EQUAL(3u, decoder.getInvalid());
+}
+
+TEST(e131_universes_make_up_a_frame) {
+    StreamDecoder decoder(1);
+    std::vector<uint8_t> data(CHANNELS, 0x33);
+    uint16_t second = CHANNELS - StreamDecoder::UNIVERSE_CHANNELS;
+    CHECK_EQUAL(STREAM_DATA, send(decoder, e131Packet(1, 1, data.data(), StreamDecoder::UNIVERSE_CHANNELS), false));
+    CHECK_EQUAL(STREAM_FRAME, send(decoder, e131Packet(2, 1, data.data(), second), false));
+    CHECK(frameIs(decoder, 0x33));
+}
+
+TEST(e131_ignores_other_universes_and_preview) {
+    StreamDecoder decoder(1);
+    uint8_t data[3] = { 9, 9, 9 };
+    CHECK_EQUAL(STREAM_INVALID, send(decoder, e131Packet(3, 1, data, 3), false));
+    CHECK_EQUAL(STREAM_INVALID, send(decoder, e131Packet(0, 1, data, 3), false));
+    CHECK_EQUAL(STREAM_INVALID, send(decoder, e131Packet(1, 1, data, 3, E131_PREVIEW), false));
+    CHECK_EQUAL(STREAM_DATA, send(decoder, e131Packet(1, 1, data, 3), false));
+}
+
+TEST(e131_terminate_only_for_own_universes) {
+    StreamDecoder decoder(1);
+    uint8_t data[3] = { 0, 0, 0 };
+    // Another source ending its stream on universe 7 must not stop ours
+    CHECK_EQUAL(STREAM_INVALID, send(decoder, e131Packet(7, 1, data, 3, E131_TERMINATED), false));
+    CHECK_EQUAL(STREAM_INVALID, send(decoder, e131Packet(1, 1, data, 3, E131_TERMINATED | E131_PREVIEW), false));
+    CHECK_EQUAL(STREAM_END, send(decoder, e131Packet(2, 1, data, 3, E131_TERMINATED), false));
+}
+
+TEST(e131_late_packets_are_dropped) {
+    StreamDecoder decoder(1);
+    uint8_t data[3] = { 0, 0, 0 };
+    CHECK_EQUAL(STREAM_DATA, send(decoder, e131Packet(1, 10, data, 3), false));
+    CHECK_EQUAL(STREAM_LATE, send(decoder, e131Packet(1, 10, data, 3), false));
+    CHECK_EQUAL(STREAM_LATE, send(decoder, e131Packet(1, 250, data, 3), false));
+    // Sequences are per universe
+    CHECK_EQUAL(STREAM_DATA, send(decoder, e131Packet(2, 3, data, 3), false));
+    // 20 or more behind is a restarted source; universe 1 after 2 starts a new frame
+    CHECK_EQUAL(STREAM_FRAME, send(decoder, e131Packet(1, 246, data, 3), false));
+    CHECK_EQUAL(2u, decoder.getLate());
+}
+
+// Every frame fills all channels with its number and goes out in several packets.
+// Now and then a packet of the previous frame turns up again after the new frame
+// started; it must be dropped, so a shown frame never mixes two frames.
+static void soak(bool ddp) {
+    StreamDecoder decoder(1);
+    Prng rng(0x5EED1234);
+    const int FRAMES = 2000;
+    const uint16_t CHUNK = ddp ? 200 : StreamDecoder::UNIVERSE_CHANNELS;
+    uint8_t sequence = 0;
+    uint8_t universeSequence[StreamDecoder::UNIVERSES] = {};
+    std::vector<uint8_t> stale;
+    uint32_t stales = 0;
+    uint32_t shown = 0;
+
+    for (int f = 0; f < FRAMES; f++) {
+        std::vector<uint8_t> data(CHANNELS, (uint8_t)f);
+        std::vector<uint8_t> firstPacket;
+        for (uint16_t offset = 0, chunk = 0; offset < CHANNELS; offset += CHUNK, chunk++) {
+            uint16_t length = CHANNELS - offset < CHUNK ? CHANNELS - offset : CHUNK;
+            std::vector<uint8_t> packet;
+            if (ddp) {
+                sequence = sequence % 15 + 1;
+                packet = ddpPacket(sequence, offset, &data[offset], length, offset + length == CHANNELS);
+            } else {
+                packet = e131Packet(1 + chunk, ++universeSequence[chunk], &data[offset], length);
+            }
+            if (chunk == 0) firstPacket = packet;
+
+            StreamResult result = send(decoder, packet, ddp);
+            CHECK(result == STREAM_DATA || result == STREAM_FRAME);
+            if (result == STREAM_FRAME) {
+                shown++;
+                CHECK(frameIs(decoder, decoder.frame()[0]));
+            }
+
+            if (chunk == 0 && !stale.empty() && rng.chance(20)) {
+                CHECK_EQUAL(STREAM_LATE, send(decoder, stale, ddp));
+                stales++;
+            }
+        }
+        CHECK(frameIs(decoder, (uint8_t)f));
+        stale = firstPacket;
+    }
+    CHECK_EQUAL((uint32_t)FRAMES, shown);
+    CHECK_EQUAL((uint32_t)FRAMES, decoder.getFrames());
+    CHECK_EQUAL(stales, decoder.getLate());
+    CHECK(stales > 100);
+    CHECK_EQUAL(0u, decoder.getInvalid());
+}
+
+TEST(ddp_soak_with_stale_packets) {
+    soak(true);
+}
+
+TEST(e131_soak_with_stale_packets) {
+    soak(false);
+}
@@ -0,0 +1,119 @@
+// The UART output's WS2812 encoding, checked as the waveform the strip receives:
+// every encoded byte is sent as an inverted 6N1 UART frame, and the resulting
+// line is decoded back into WS2812 bits by measuring each pulse.
+#include "unit-test.h"
+#include "ws2812-encoder.h"
+
+static const double SLOT_NS = 1e9 / WS2812_UART_BAUD;  // 312.5 ns
+
+// Line levels of UART bytes at 6N1 with TX inverted: start bit (0, sent high),
+// six data bits LSB first (inverted), stop bit (1, sent low)
+static std::vector<bool> uartLine(const uint8_t* bytes, size_t count) {
+    std::vector<bool> line;
+    for (size_t i = 0; i < count; i++) {
+        line.push_back(!false);
+        for (int bit = 0; bit < 6; bit++) {
+            line.push_back(!((bytes[i] >> bit) & 1));
+        }
+        line.push_back(!true);
+    }
+    return line;
+}
+
+// Decode the line as a WS2812 would: every bit is one high pulse followed by low,
+// 1.25 us per bit; a short pulse is 0 and a long one 1. Pulses outside the
+// datasheet windows (T0H 250-550 ns, T1H 650-950 ns) fail the check.
+static std::vector<uint8_t> decodeWs2812(const std::vector<bool>& line) {
+    std::vector<uint8_t> bytes;
+    uint8_t current = 0;
+    int bits = 0;
+    for (size_t start = 0; start + 4 <= line.size(); start += 4) {
+        CHECK(line[start]);
+        size_t high = 0;
+        while (high < 4 && line[start + high]) high++;
+        for (size_t slot = high; slot < 4; slot++) {
+            CHECK(!line[start + slot]);
+        }
+
+        double highNs = high * SLOT_NS;
+        bool one = highNs >= 650 && highNs <= 950;
+        bool zero = highNs >= 250 && highNs <= 550;
+        CHECK(one || zero);
+        CHECK(4 * SLOT_NS >= 1250 - 150 && 4 * SLOT_NS <= 1250 + 150);
+
+        current = (current << 1) | (one ? 1 : 0);
+        if (++bits == 8) {
+            bytes.push_back(current);
+            current = 0;
+            bits = 0;
+        }
+    }
+    CHECK_EQUAL(0, bits);
+    return bytes;
+}
+
+TEST(every_byte_value_round_trips) {
+    for (int value = 0; value < 256; value++) {
+        uint8_t encoded[WS2812_UART_BYTES_PER_CHANNEL];
+        uint8_t* end = ws2812EncodeChannel(value, encoded);
+        CHECK(end == encoded + WS2812_UART_BYTES_PER_CHANNEL);
+
+        std::vector<bool> line = uartLine(encoded, WS2812_UART_BYTES_PER_CHANNEL);
+        CHECK_EQUAL((size_t)32, line.size());
+        std::vector<uint8_t> decoded = decodeWs2812(line);
+        CHECK_EQUAL((size_t)1, decoded.size());
+        if (decoded.size() == 1) {
+            CHECK_EQUAL(value, (int)decoded[0]);
+        }
+    }
+}
+
+TEST(uart_frames_match_the_encoder_line_model) {
+    // The compile-time pulse checks in ws2812-encoder.h use ws2812UartLineHigh();
+    // it must agree with a real inverted 6N1 frame, start high and stop low
+    for (int pair = 0; pair < 4; pair++) {
+        uint8_t pattern = WS2812_UART_PATTERNS[pair];
+        CHECK((pattern & ~0x3F) == 0);
+        std::vector<bool> line = uartLine(&pattern, 1);
+        CHECK(line[0]);
+        CHECK(!line[7]);
+        for (uint8_t slot = 0; slot < 8; slot++) {
+            CHECK(line[slot] == ws2812UartLineHigh(pattern, slot));
+        }
+    }
+}
+
+static std::vector<uint8_t> sendPixels(const uint32_t* pixels, uint16_t count, Ws2812Order order) {
+    std::vector<uint8_t> encoded(count * 3 * WS2812_UART_BYTES_PER_CHANNEL);
+    uint32_t length = ws2812EncodeUart(pixels, count, order, encoded.data());
+    CHECK_EQUAL((uint32_t)encoded.size(), length);
+    return decodeWs2812(uartLine(encoded.data(), length));
+}
+
+TEST(pixels_go_out_in_wire_order) {
+    const uint32_t pixels[] = { 0x123456, 0xFF0080, 0x000000, 0xFFFFFF };
+
+    std::vector<uint8_t> grb = sendPixels(pixels, 4, WS2812_ORDER_GRB);
+    const uint8_t expectedGrb[] = { 0x34, 0x12, 0x56, 0x00, 0xFF, 0x80, 0, 0, 0, 0xFF, 0xFF, 0xFF };
+    CHECK(grb == std::vector<uint8_t>(expectedGrb, expectedGrb + sizeof(expectedGrb)));
+
+    std::vector<uint8_t> bgr = sendPixels(pixels, 4, WS2812_ORDER_BGR);
+    const uint8_t expectedBgr[] = { 0x56, 0x34, 0x12, 0x80, 0x00, 0xFF, 0, 0, 0, 0xFF, 0xFF, 0xFF };
+    CHECK(bgr == std::vector<uint8_t>(expectedBgr, expectedBgr + sizeof(expectedBgr)));
+}
+
+TEST(whole_strip_frame) {
+    uint32_t pixels[224];
+    for (int i = 0; i < 224; i++) {
+        pixels[i] = (uint32_t)i * 0x010203;
+    }
+    std::vector<uint8_t> wire = sendPixels(pixels, 224, WS2812_ORDER_GRB);
+    CHECK_EQUAL((size_t)224 * 3, wire.size());
+    bool matches = true;
+    for (int i = 0; i < 224 && wire.size() == 224 * 3; i++) {
+        matches &= wire[i * 3] == ((pixels[i] >> 8) & 0xFF);
+        matches &= wire[i * 3 + 1] == ((pixels[i] >> 16) & 0xFF);
+        matches &= wire[i * 3 + 2] == (pixels[i] & 0xFF);
+    }
+    CHECK(matches);
+}
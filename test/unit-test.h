@@ -0,0 +1,80 @@
+// unit-test.h - Minimal test runner for the host build
+#pragma once
+
+// Each test program is one .cpp file that includes this header once; it supplies
+// main(), which runs every TEST in the file and fails if any CHECK did.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct UnitTest {
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<UnitTest>& unitTests() {
+    static std::vector<UnitTest> tests;
+    return tests;
+}
+
+inline int& unitTestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+struct UnitTestRegistrar {
+    UnitTestRegistrar(const char* name, void (*run)()) { unitTests().push_back({ name, run }); }
+};
+
+#define TEST(name) \
+    static void name(); \
+    static UnitTestRegistrar name##Registrar(#name, name); \
+    static void name()
+
+template<typename T>
+std::string unitTestDescribe(const T& value) {
+    if constexpr (std::is_enum<T>::value) {
+        return std::to_string((long long)value);
+    } else if constexpr (std::is_integral<T>::value) {
+        return std::to_string(value);
+    } else if constexpr (std::is_floating_point<T>::value) {
+        return std::to_string(value);
+    } else if constexpr (std::is_same<T, std::string>::value) {
+        return "\"" + value + "\"";
+    } else if constexpr (std::is_convertible<T, const char*>::value) {
+        return std::string("\"") + (const char*)value + "\"";
+    } else {
+        return "?";
+    }
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            unitTestFailures()++; \
+        } \
+    } while (0)
+
+#define CHECK_EQUAL(expected, actual) \
+    do { \
+        auto expectedValue = (expected); \
+        auto actualValue = (actual); \
+        if (!(expectedValue == actualValue)) { \
+            printf("%s:%d: %s == %s failed: expected %s, got %s\n", __FILE__, __LINE__, #expected, #actual, \
+                   unitTestDescribe(expectedValue).c_str(), unitTestDescribe(actualValue).c_str()); \
+            unitTestFailures()++; \
+        } \
+    } while (0)
+
+int main() {
+    for (const UnitTest& test : unitTests()) {
+        int before = unitTestFailures();
+        test.run();
+        printf("%s %s\n", unitTestFailures() == before ? "PASS" : "FAIL", test.name);
+    }
+    printf("%zu tests, %d failed checks\n", unitTests().size(), unitTestFailures());
+    return unitTestFailures() ? 1 : 0;
+}